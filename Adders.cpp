@@ -1,58 +1,28 @@
 #include "Game.hpp"
 
-void Game::addEnemy(float x, float y, float angle) {
-    enemies.push_back(std::make_unique<Enemy>(x, y, angle));
+void Game::addEnemy(float x, float y, float angle, int type) {
+    int i = enemies.add(x, y, angle, type);
+    maxEnemySize = std::max(maxEnemySize, enemies.get_size(i));
 }
 
 void Game::addWallTexture(const char* filePath)
 {
-    SDL_Texture* raw = IMG_LoadTexture(renderer.get(), filePath);
-    if (!raw) {
-        std::cerr << "Failed to load wall texture: "
-                  << filePath << " | " << IMG_GetError() << "\n";
-        return;
-    }
-
-    wallTextures.emplace_back(raw, SDL_DestroyTexture);
-
-    int width = 0, height = 0;
-    if (SDL_QueryTexture(raw, nullptr, nullptr, &width, &height) != 0) {
-        std::cerr << "Failed to query texture: "
-                  << SDL_GetError() << "\n";
-        wallTextures.pop_back();   // keep vectors in sync
-        return;
-    }
-
-    wallTextureWidths.push_back(width);
-    wallTextureHeights.push_back(height);
+    loadTexture(filePath, "wall", [this](SDLTexturePtr texture, int width, int height) {
+        wallTextures.push_back(texture);
+        wallTextureWidths.push_back(width);
+        wallTextureHeights.push_back(height);
+    });
 }
 
 void Game::addDecorationTexture(char x, const char* filePath)
 {
-    SDL_Texture* raw = IMG_LoadTexture(renderer.get(), filePath);
-    if (!raw) {
-        std::cerr << "Failed to load decoration texture: "
-                  << filePath << " | " << IMG_GetError() << "\n";
-        return;
-    }
-
-    if (DecorationTextures.find(x) != DecorationTextures.end()) {
-        std::cerr << "Decoration texture already exists for key: " << x << "\n";
-        SDL_DestroyTexture(raw);
-        return;
-    }
-
-    DecorationTextures.emplace(
-        x,
-        SDLTexturePtr(raw, SDL_DestroyTexture)
-    );
-
-    int width = 0, height = 0;
-    if (SDL_QueryTexture(raw, nullptr, nullptr, &width, &height) != 0) {
-        std::cerr << "Failed to query texture: "
-                  << SDL_GetError() << "\n";
-        return;
-    }
-
-    DecorationTextureWidthsHeights[x] = { width, height };
+    // Checked on arrival: earlier requests for x may still be loading
+    loadTexture(filePath, "decoration", [this, x](SDLTexturePtr texture, int width, int height) {
+        if (DecorationTextures.find(x) != DecorationTextures.end()) {
+            std::cerr << "Decoration texture already exists for key: " << x << "\n";
+            return;
+        }
+        DecorationTextures.emplace(x, texture);
+        DecorationTextureWidthsHeights[x] = { width, height };
+    });
 }
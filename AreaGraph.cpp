@@ -0,0 +1,142 @@
+#include "AreaGraph.hpp"
+#include <algorithm>
+
+static const int dirs[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+static_assert(sizeof(int) == sizeof(int32_t), "saved tiles are read as int");
+
+void AreaGraph::clear() {
+    width = height = 0;
+    area.clear();
+    areaOf = nullptr;
+    links.clear();
+    doorOpen.clear();
+    doorOfTile.clear();
+    visited.clear();
+    stamp = 0;
+}
+
+void AreaGraph::build(int w, int h, const TileFn& isFloor,
+    const TileFn& isDoor, const TileFn& isOpen)
+{
+    clear();
+    width = w;
+    height = h;
+    area.assign(static_cast<size_t>(w) * h, -1);
+    areaOf = area.data();
+
+    // Areas: 4-connected floor, doors left out so they split rooms
+    std::vector<int> stack;
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            if (area[y * w + x] >= 0 || !isFloor(x, y)) continue;
+            int id = static_cast<int>(links.size());
+            links.emplace_back();
+            area[y * w + x] = id;
+            stack.push_back(y * w + x);
+            while (!stack.empty()) {
+                int t = stack.back();
+                stack.pop_back();
+                int tx = t % w, ty = t / w;
+                for (const auto& d : dirs) {
+                    int nx = tx + d[0], ny = ty + d[1];
+                    if (nx < 0 || ny < 0 || nx >= w || ny >= h) continue;
+                    int n = ny * w + nx;
+                    if (area[n] >= 0 || !isFloor(nx, ny)) continue;
+                    area[n] = id;
+                    stack.push_back(n);
+                }
+            }
+        }
+    }
+
+    // Doors: link the areas on opposite sides
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            if (!isDoor(x, y)) continue;
+            for (int axis = 0; axis < 2; axis++) {
+                int a = areaAt(x - (axis == 0), y - (axis == 1));
+                int b = areaAt(x + (axis == 0), y + (axis == 1));
+                if (a < 0 || b < 0) continue;
+                area[y * w + x] = a;
+                if (a == b) continue;
+                int door = static_cast<int>(doorOpen.size());
+                doorOpen.push_back(isOpen(x, y));
+                doorOfTile.emplace(y * w + x, door);
+                links[a].push_back({b, door});
+                links[b].push_back({a, door});
+                break;
+            }
+        }
+    }
+    visited.assign(links.size(), 0);
+}
+
+void AreaGraph::save(std::vector<SavedLink>& out) const {
+    out.assign(doorOpen.size(), SavedLink{-1, -1, -1, 0});
+    for (const auto& [tile, door] : doorOfTile)
+        out[door].tile = tile;
+    for (int a = 0; a < areaCount(); a++)
+        for (const Link& l : links[a])
+            if (a < l.to) {
+                out[l.door].a = a;
+                out[l.door].b = l.to;
+            }
+    for (size_t d = 0; d < doorOpen.size(); d++)
+        out[d].open = doorOpen[d];
+}
+
+bool AreaGraph::load(int w, int h, const int32_t* tiles, int count,
+    const SavedLink* saved, size_t linkCount)
+{
+    clear();
+    // Everything here is used as an index: reject what a build could
+    // not have produced rather than read past the arrays
+    size_t tileCount = static_cast<size_t>(w) * h;
+    if (count < 0) return false;
+    for (size_t t = 0; t < tileCount; t++)
+        if (tiles[t] < -1 || tiles[t] >= count) return false;
+    for (size_t d = 0; d < linkCount; d++)
+        if (saved[d].a < 0 || saved[d].a >= count || saved[d].b < 0 || saved[d].b >= count ||
+            saved[d].tile < 0 || (size_t)saved[d].tile >= tileCount)
+            return false;
+    width = w;
+    height = h;
+    areaOf = tiles;
+    links.resize(count);
+    // Same order as build(), so floods visit areas in the same order
+    for (size_t d = 0; d < linkCount; d++) {
+        const SavedLink& l = saved[d];
+        int door = static_cast<int>(d);
+        doorOpen.push_back(l.open != 0);
+        doorOfTile.emplace(l.tile, door);
+        links[l.a].push_back({l.b, door});
+        links[l.b].push_back({l.a, door});
+    }
+    visited.assign(links.size(), 0);
+    return true;
+}
+
+void AreaGraph::setDoorOpen(int x, int y, bool open) {
+    if (x < 0 || y < 0 || x >= width || y >= height) return;
+    auto it = doorOfTile.find(y * width + x);
+    if (it != doorOfTile.end())
+        doorOpen[it->second] = open;
+}
+
+void AreaGraph::flood(int from, std::vector<int>& out) const {
+    out.clear();
+    if (from < 0 || from >= areaCount()) return;
+    if (++stamp == 0) { // wrapped: old stamps could collide
+        std::fill(visited.begin(), visited.end(), 0);
+        stamp = 1;
+    }
+    visited[from] = stamp;
+    out.push_back(from);
+    for (size_t head = 0; head < out.size(); head++) {
+        for (const Link& l : links[out[head]]) {
+            if (!doorOpen[l.door] || visited[l.to] == stamp) continue;
+            visited[l.to] = stamp;
+            out.push_back(l.to);
+        }
+    }
+}
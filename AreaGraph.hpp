@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+// Rooms of the map, as in the original game: floor is split into areas
+// at door tiles, and each door links the two areas on its sides. A link
+// carries sound (and sight of the next room) only while its door is
+// not fully closed. Built once at load; doors toggle links as they move.
+class AreaGraph {
+public:
+    using TileFn = std::function<bool(int, int)>;
+
+    // isFloor: walkable non-door tile, isDoor: door tile,
+    // isOpen: door currently not fully closed
+    void build(int width, int height, const TileFn& isFloor,
+               const TileFn& isDoor, const TileFn& isOpen);
+    void clear();
+
+    // Area of a tile, -1 for walls. A door tile belongs to the area on
+    // its first open side.
+    int areaAt(int x, int y) const {
+        if (x < 0 || y < 0 || x >= width || y >= height) return -1;
+        return areaOf[y * width + x];
+    }
+    int areaCount() const { return static_cast<int>(links.size()); }
+
+    // A door started opening (open) or shut completely (!open)
+    void setDoorOpen(int x, int y, bool open);
+
+    // Every area reachable from `from` through open doors, `from`
+    // included. Cost is per area and link visited.
+    void flood(int from, std::vector<int>& out) const;
+
+    // Saved form, for compiled levels: the per-tile areas plus one
+    // record per door link, in door order. load() borrows tiles, which
+    // must outlive the graph; false if the links do not fit areaCount.
+    struct SavedLink {
+        int32_t a, b;
+        int32_t tile;
+        int32_t open;
+    };
+    const int* areaTiles() const { return areaOf; }
+    void save(std::vector<SavedLink>& out) const;
+    bool load(int width, int height, const int32_t* tiles, int areaCount,
+              const SavedLink* saved, size_t count);
+
+private:
+    struct Link {
+        int to;
+        int door;   // index into doorOpen
+    };
+
+    int width = 0, height = 0;
+    std::vector<int> area;                 // tile -> area, -1 if none
+    const int* areaOf = nullptr;           // area's data, or a loaded view
+    std::vector<std::vector<Link>> links;  // per area
+    std::vector<uint8_t> doorOpen;
+    std::unordered_map<int, int> doorOfTile;
+
+    // Visit stamps, so a flood never clears a per-area array
+    mutable std::vector<unsigned> visited;
+    mutable unsigned stamp = 0;
+};
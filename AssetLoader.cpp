@@ -0,0 +1,433 @@
+#include "AssetLoader.hpp"
+#include "AssetPack.hpp"
+#include "JobSystem.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+std::vector<AssetLoader::Request> AssetLoader::requests;
+std::vector<AssetLoader::File> AssetLoader::files;
+size_t AssetLoader::delivered = 0;
+bool AssetLoader::grouped = false;
+std::thread AssetLoader::decoder;
+std::mutex AssetLoader::mutex;
+std::condition_variable AssetLoader::decoded;
+std::atomic<bool> AssetLoader::cancelled{false};
+std::unordered_map<std::string, std::string> AssetLoader::pathSources;
+std::unordered_map<std::string, AssetLoader::Cached> AssetLoader::cache;
+std::unordered_multimap<uint64_t, std::string> AssetLoader::contents;
+std::map<std::string, AssetLoader::Usage> AssetLoader::usage;
+AssetLoader::Usage AssetLoader::shared;
+int AssetLoader::decodes = 0;
+
+// FNV-1a, 64 bit: enough to find candidates, which are then compared
+static uint64_t hashBytes(const void* data, size_t size) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < size; i++)
+        h = (h ^ p[i]) * 0x100000001b3ull;
+    return h;
+}
+
+void AssetLoader::queue(Request r) {
+    requests.push_back(std::move(r));
+}
+
+void AssetLoader::image(const std::string& path, SurfaceFn done) {
+    Request r;
+    r.kind = Kind::IMAGE;
+    r.path = path;
+    r.onSurface = std::move(done);
+    queue(std::move(r));
+}
+
+void AssetLoader::texture(SDL_Renderer* renderer, const std::string& path,
+                          const char* category, TextureFn done) {
+    Request r;
+    r.kind = Kind::TEXTURE;
+    r.path = path;
+    r.category = category;
+    r.renderer = renderer;
+    r.onTexture = std::move(done);
+    queue(std::move(r));
+}
+
+void AssetLoader::sound(const std::string& path, ChunkFn done) {
+    Request r;
+    r.kind = Kind::SOUND;
+    r.path = path;
+    r.category = "sound";
+    r.onChunk = std::move(done);
+    queue(std::move(r));
+}
+
+void AssetLoader::music(const std::string& path, MusicFn done) {
+    Request r;
+    r.kind = Kind::MUSIC;
+    r.path = path;
+    r.category = "music";
+    r.onMusic = std::move(done);
+    queue(std::move(r));
+}
+
+std::string AssetLoader::fileKey(Kind family, const std::string& path) {
+    return std::to_string((int)family) + ':' + AssetPack::key(path);
+}
+
+// Take a strong reference to the cached handle a request of this kind
+// needs, so it cannot expire before delivery
+bool AssetLoader::hold(File& f, Kind kind) {
+    auto c = cache.find(f.source);
+    if (c == cache.end()) return false;
+    switch (kind) {
+    case Kind::TEXTURE:
+        if (!f.texture) f.texture = c->second.texture.lock();
+        return f.texture != nullptr;
+    case Kind::SOUND:
+        if (!f.sound) f.sound = c->second.chunk.lock();
+        return f.sound != nullptr;
+    case Kind::MUSIC:
+        if (!f.track) f.track = c->second.musicTrack.lock();
+        return f.track != nullptr;
+    default:
+        return false; // surfaces are not kept
+    }
+}
+
+// The cached file's bytes are read again to compare: packed ones are
+// mapped, loose ones cost a read, only on a hash and size match
+bool AssetLoader::sameAsCached(const File& f, const Cached& c) {
+    if (c.family != f.family || c.size != f.size)
+        return false;
+    std::vector<char> storage;
+    size_t size = 0;
+    const void* data = AssetPack::read(c.path, storage, size);
+    return data && size == f.size && std::memcmp(data, f.data, f.size) == 0;
+}
+
+// Filled (or refilled, if the file changed) once the file has a handle
+AssetLoader::Cached& AssetLoader::entry(const File& f) {
+    Cached& c = cache[f.source];
+    c.family = f.family;
+    c.path = f.path;
+    c.size = f.size;
+    if (f.family == Kind::MUSIC)
+        return c;
+    auto range = contents.equal_range(f.hash);
+    for (auto it = range.first; it != range.second; ++it)
+        if (it->second == f.source)
+            return c;
+    contents.emplace(f.hash, f.source);
+    return c;
+}
+
+// On a worker. SDL keeps its error string per thread, so it is copied
+// out for the main thread.
+void AssetLoader::readFile(File& f) {
+    if (f.family == Kind::MUSIC) {
+        // Streamed: keyed by name, only the size is needed
+        std::string name = "music:" + AssetPack::key(f.path);
+        f.hash = hashBytes(name.data(), name.size());
+        if (!AssetPack::find(f.path, f.size)) {
+            SDL_RWops* rw = SDL_RWFromFile(f.path.c_str(), "rb");
+            if (rw) {
+                f.size = static_cast<size_t>(std::max<Sint64>(SDL_RWsize(rw), 0));
+                SDL_RWclose(rw);
+            }
+        }
+        return;
+    }
+    f.data = AssetPack::read(f.path, f.storage, f.size);
+    if (!f.data) {
+        f.error = SDL_GetError();
+        return;
+    }
+    f.hash = hashBytes(f.data, f.size);
+}
+
+// Between the two parallel passes: each file's owner is the first file
+// with the same bytes. An owner whose bytes match a file cached by an
+// earlier batch is served from that entry.
+void AssetLoader::shareDecodes() {
+    std::unordered_map<uint64_t, std::vector<int>> byHash;
+    for (int i = 0; i < (int)files.size(); i++) {
+        File& f = files[i];
+        f.owner = i;
+        if (f.cached || !f.error.empty() || f.family == Kind::MUSIC)
+            continue;
+        for (int j : byHash[f.hash]) {
+            const File& g = files[j];
+            if (g.family == f.family && g.size == f.size &&
+                std::memcmp(g.data, f.data, f.size) == 0) {
+                f.owner = j;
+                break;
+            }
+        }
+        if (f.owner != i)
+            continue;
+        byHash[f.hash].push_back(i);
+        // No match: whatever is cached under its own path is stale
+        f.needsDecode = true;
+        auto range = contents.equal_range(f.hash);
+        for (auto it = range.first; it != range.second; ++it)
+            if (sameAsCached(f, cache.at(it->second))) {
+                f.source = it->second;
+                f.needsDecode = false;
+                break;
+            }
+    }
+    for (File& f : files) {
+        if (f.owner != &f - files.data()) {
+            std::vector<char>().swap(f.storage);
+            f.data = nullptr;
+        }
+    }
+}
+
+void AssetLoader::decode(File& f) {
+    switch (f.family) {
+    case Kind::IMAGE:
+        f.surface = AssetPack::decodeImage(f.data, f.size, f.path);
+        if (!f.surface) f.error = IMG_GetError();
+        break;
+    case Kind::SOUND:
+        f.chunk = AssetPack::decodeSound(f.data, f.size);
+        if (!f.chunk) f.error = Mix_GetError();
+        break;
+    default:
+        break;
+    }
+    // Decoded copies hold what they need; packed bytes stay mapped
+    std::vector<char>().swap(f.storage);
+    f.data = nullptr;
+}
+
+void AssetLoader::account(const std::string& category, size_t bytes, bool wasShared) {
+    Usage& u = wasShared ? shared : usage[category];
+    u.count++;
+    u.bytes += bytes;
+}
+
+// On the main thread: upload or reuse, then hand over
+void AssetLoader::deliver(Request& r) {
+    File& f = files[r.file];
+    File& src = files[f.owner];
+    if (!src.error.empty())
+        SDL_SetError("%s", src.error.c_str());
+    if (src.error.empty())
+        pathSources[fileKey(f.family, f.path)] = src.source;
+    switch (r.kind) {
+    case Kind::IMAGE:
+        r.onSurface(src.surface);
+        break;
+    case Kind::TEXTURE: {
+        // Kept by the owner, so the rest of the batch shares it too
+        SDLTexturePtr texture = src.texture;
+        if (texture)
+            account(r.category, cache[src.source].bytes, true);
+        else if (src.surface) {
+            SDL_Texture* raw = SDL_CreateTextureFromSurface(r.renderer, src.surface);
+            if (raw) {
+                texture = SDLTexturePtr(raw, SDL_DestroyTexture);
+                src.texture = texture;
+                Cached& c = entry(src);
+                c.texture = texture;
+                // Renderers store 32-bit texels whatever the PNG held
+                c.bytes = static_cast<size_t>(src.surface->w) * src.surface->h * 4;
+                account(r.category, c.bytes, false);
+            }
+        }
+        r.onTexture(texture);
+        break;
+    }
+    case Kind::SOUND: {
+        MixChunkPtr chunk = src.sound;
+        if (chunk)
+            account(r.category, cache[src.source].bytes, true);
+        else if (src.chunk) {
+            chunk = MixChunkPtr(src.chunk, Mix_FreeChunk);
+            src.chunk = nullptr;
+            src.sound = chunk;
+            Cached& c = entry(src);
+            c.chunk = chunk;
+            c.bytes = chunk->alen;
+            account(r.category, c.bytes, false);
+        }
+        r.onChunk(chunk);
+        break;
+    }
+    case Kind::MUSIC: {
+        // Opened here, not on a worker: SDL_mixer sets up its decoders
+        // on first use without locking. Opening only reads the header.
+        MixMusicPtr track = src.track;
+        if (track)
+            account(r.category, cache[src.source].bytes, true);
+        else if (Mix_Music* opened = AssetPack::loadMusic(src.path)) {
+            decodes++;
+            track = MixMusicPtr(opened, Mix_FreeMusic);
+            src.track = track;
+            Cached& c = entry(src);
+            c.musicTrack = track;
+            c.bytes = src.size;
+            account(r.category, c.bytes, false);
+        }
+        r.onMusic(track);
+        break;
+    }
+    }
+    r.onSurface = nullptr;
+    r.onTexture = nullptr;
+    r.onChunk = nullptr;
+    r.onMusic = nullptr;
+    if (--src.usersLeft == 0)
+        release(src);
+}
+
+void AssetLoader::release(File& f) {
+    if (f.surface) SDL_FreeSurface(f.surface);
+    if (f.chunk) Mix_FreeChunk(f.chunk);
+    f.surface = nullptr;
+    f.chunk = nullptr;
+    f.texture.reset();
+    f.sound.reset();
+    f.track.reset();
+    std::vector<char>().swap(f.storage);
+}
+
+void AssetLoader::start() {
+    if (decoder.joinable() || delivered == requests.size())
+        return;
+
+    // One file per distinct path; files whose requests the cache can
+    // all serve are not read at all
+    std::unordered_map<std::string, int> fileOf;
+    files.clear();
+    for (Request& r : requests) {
+        Kind family = r.kind == Kind::TEXTURE ? Kind::IMAGE : r.kind;
+        std::string key = fileKey(family, r.path);
+        auto it = fileOf.find(key);
+        if (it == fileOf.end()) {
+            it = fileOf.emplace(key, (int)files.size()).first;
+            File f;
+            f.family = family;
+            f.path = r.path;
+            auto s = pathSources.find(key);
+            f.cached = s != pathSources.end();
+            f.source = f.cached ? s->second : key;
+            files.push_back(std::move(f));
+        }
+        r.file = it->second;
+        File& f = files[r.file];
+        if (f.cached && !hold(f, r.kind))
+            f.cached = false;
+    }
+    // Read again: the bytes decide which entry it belongs to
+    for (File& f : files)
+        if (!f.cached) {
+            f.source = fileKey(f.family, f.path);
+            f.texture.reset();
+            f.sound.reset();
+            f.track.reset();
+        }
+
+    grouped = false;
+    cancelled = false;
+    // parallelFor blocks its caller, so it gets a thread of its own;
+    // that thread works too
+    decoder = std::thread([] {
+        JobSystem::parallelFor((int)files.size(), 1, [](int begin, int end) {
+            for (int i = begin; i < end; i++)
+                if (!cancelled && !files[i].cached)
+                    readFile(files[i]);
+        });
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            shareDecodes();
+            // An owner decodes unless it holds a handle for each request
+            for (const Request& r : requests) {
+                File& owner = files[files[r.file].owner];
+                owner.usersLeft++;
+                if (!owner.cached && !owner.needsDecode && owner.error.empty() &&
+                    !hold(owner, r.kind))
+                    owner.needsDecode = true;
+            }
+            // Nothing to decode: ready now. Music is opened on delivery.
+            for (File& f : files) {
+                f.ready = !f.needsDecode || f.family == Kind::MUSIC;
+                if (f.needsDecode && f.family != Kind::MUSIC)
+                    decodes++;
+            }
+            grouped = true;
+        }
+        decoded.notify_all();
+        JobSystem::parallelFor((int)files.size(), 1, [](int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                File& f = files[i];
+                if (f.owner != i || f.ready)
+                    continue;
+                if (!cancelled)
+                    decode(f);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    f.ready = true;
+                }
+                decoded.notify_all();
+            }
+        });
+    });
+}
+
+// Called with the mutex held
+bool AssetLoader::isReady(const Request& r) {
+    return grouped && files[files[r.file].owner].ready;
+}
+
+bool AssetLoader::pump(Uint32 budgetMs) {
+    start();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(budgetMs);
+    while (delivered < requests.size()) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!decoded.wait_until(lock, deadline, [] { return isReady(requests[delivered]); }))
+                return false;
+        }
+        deliver(requests[delivered++]);
+        if (std::chrono::steady_clock::now() >= deadline && delivered < requests.size())
+            return false;
+    }
+    reset();
+    return true;
+}
+
+void AssetLoader::finish() {
+    while (!pump(1000)) {}
+}
+
+void AssetLoader::cancel() {
+    cancelled = true;
+    reset();
+}
+
+void AssetLoader::reset() {
+    if (decoder.joinable())
+        decoder.join();
+    for (File& f : files)
+        release(f);
+    requests.clear();
+    files.clear();
+    delivered = 0;
+    grouped = false;
+}
+
+float AssetLoader::progress() {
+    return requests.empty() ? 1.0f : (float)delivered / requests.size();
+}
+
+void AssetLoader::report() {
+    std::cout << "Assets: " << decodes << " decoded, " << shared.count
+              << " loads shared a handle (" << shared.bytes / 1024 << " KB not duplicated)\n";
+    for (const auto& [category, u] : usage)
+        std::cout << "  " << category << ": " << u.count << " handles, "
+                  << u.bytes / 1024 << " KB\n";
+}
@@ -0,0 +1,145 @@
+#pragma once
+#include "SDL.h"
+#include "SDL_image.h"
+#include "SDL_mixer.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Shared handles: one decoded asset may back many users
+using SDLTexturePtr = std::shared_ptr<SDL_Texture>;
+using MixChunkPtr = std::shared_ptr<Mix_Chunk>;
+using MixMusicPtr = std::shared_ptr<Mix_Music>;
+
+// Asset loads queued while the configs are read, then decoded (PNG,
+// WAV) on the JobSystem workers while the main thread draws the
+// loading screen. Results are handed back on the main thread, in the
+// order requested, so loaders that number things by arrival keep
+// working; textures are uploaded and music is opened there too. A failed load hands back
+// nullptr with its SDL error set, so IMG_GetError()/Mix_GetError() read
+// as they did when loading was serial.
+//
+// Loads are content addressed: requests for one path, or for paths
+// whose bytes are identical, share one decode and one handle. A content
+// hash only finds candidates; bytes are compared before anything is
+// shared. Handles stay cached for as long as anyone holds them. Music
+// streams from its file, so it is shared by path only.
+class AssetLoader {
+public:
+    using SurfaceFn = std::function<void(SDL_Surface*)>;  // freed after loading
+    using TextureFn = std::function<void(SDLTexturePtr)>;
+    using ChunkFn = std::function<void(MixChunkPtr)>;
+    using MusicFn = std::function<void(MixMusicPtr)>;
+
+    // category: what the memory report counts the texture under
+    static void image(const std::string& path, SurfaceFn done);
+    static void texture(SDL_Renderer* renderer, const std::string& path,
+                        const char* category, TextureFn done);
+    static void sound(const std::string& path, ChunkFn done);
+    static void music(const std::string& path, MusicFn done);
+
+    // Decode everything queued so far. The JobSystem is busy until all
+    // of it is delivered: nothing else may parallelFor meanwhile.
+    static void start();
+    // Deliver finished loads for up to budgetMs; true once all are in
+    static bool pump(Uint32 budgetMs);
+    // start() and pump until done, for when nothing is drawn
+    static void finish();
+    // Drop whatever is not delivered yet (quit during loading)
+    static void cancel();
+    static float progress();
+
+    // Handles made per category, and what sharing saved
+    static void report();
+
+private:
+    enum class Kind { IMAGE, TEXTURE, SOUND, MUSIC };
+    struct Request {
+        Kind kind;
+        std::string path;
+        std::string category;
+        SDL_Renderer* renderer = nullptr;
+        SurfaceFn onSurface;
+        TextureFn onTexture;
+        ChunkFn onChunk;
+        MusicFn onMusic;
+        int file = -1;
+    };
+    // One per distinct path in the batch. Files with the same bytes
+    // share the decode of the first of them, their owner.
+    struct File {
+        Kind family;            // IMAGE (textures too), SOUND or MUSIC
+        std::string path;
+        std::vector<char> storage;  // loose file bytes
+        const void* data = nullptr;
+        size_t size = 0;
+        uint64_t hash = 0;
+        std::string source;     // cache entry it is served from or fills
+        bool cached = false;    // every request served from the cache
+        bool needsDecode = false;
+        int owner = -1;
+        int usersLeft = 0;      // owner: requests still to deliver
+        SDL_Surface* surface = nullptr;
+        Mix_Chunk* chunk = nullptr;
+        // Handles taken from the cache, held until the batch is delivered
+        SDLTexturePtr texture;
+        MixChunkPtr sound;
+        MixMusicPtr track;
+        std::string error;
+        bool ready = false;     // guarded by mutex
+    };
+    // Keyed by the file that filled it; path and size let a later
+    // batch compare its bytes
+    struct Cached {
+        std::weak_ptr<SDL_Texture> texture;
+        std::weak_ptr<Mix_Chunk> chunk;
+        std::weak_ptr<Mix_Music> musicTrack;
+        size_t bytes = 0;
+        Kind family = Kind::IMAGE;
+        std::string path;
+        size_t size = 0;
+    };
+    struct Usage {
+        int count = 0;
+        size_t bytes = 0;
+    };
+
+    static void queue(Request r);
+    static std::string fileKey(Kind family, const std::string& path);
+    static bool hold(File& f, Kind kind);
+    static bool sameAsCached(const File& f, const Cached& c);
+    static Cached& entry(const File& f);
+    static void readFile(File& f);
+    static void shareDecodes();
+    static void decode(File& f);
+    static void deliver(Request& r);
+    static void release(File& f);
+    static void reset();
+    static bool isReady(const Request& r);
+    static void account(const std::string& category, size_t bytes, bool shared);
+
+    static std::vector<Request> requests;
+    static std::vector<File> files;
+    static size_t delivered;
+    static bool grouped;                 // owners known; guarded by mutex
+    static std::thread decoder;
+    static std::mutex mutex;
+    static std::condition_variable decoded;
+    static std::atomic<bool> cancelled;
+
+    // Main thread only, except that the decoder thread reads the cache
+    // before grouped is set: nothing is delivered until then
+    static std::unordered_map<std::string, std::string> pathSources;
+    static std::unordered_map<std::string, Cached> cache;
+    static std::unordered_multimap<uint64_t, std::string> contents;
+    static std::map<std::string, Usage> usage;
+    static Usage shared;
+    static int decodes;
+};
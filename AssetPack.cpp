@@ -0,0 +1,132 @@
+#include "AssetPack.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+
+MappedFile AssetPack::file;
+const PackEntry* AssetPack::entries = nullptr;
+const char* AssetPack::names = nullptr;
+uint32_t AssetPack::count = 0;
+
+std::string AssetPack::key(const std::string& path) {
+    std::string key = path;
+    std::replace(key.begin(), key.end(), '\\', '/');
+    while (key.compare(0, 2, "./") == 0)
+        key.erase(0, 2);
+    return key;
+}
+
+// Extension for the typed loaders, as IMG_Load takes it from the name
+static const char* extensionOf(const std::string& path) {
+    size_t dot = path.find_last_of('.');
+    return dot == std::string::npos ? nullptr : path.c_str() + dot + 1;
+}
+
+// Mix_LoadMUS picks the decoder from the file name; the stream has none
+static Mix_MusicType musicType(const std::string& path) {
+    const char* ext = extensionOf(path);
+    if (!ext) return MUS_NONE;
+    if (SDL_strcasecmp(ext, "mp3") == 0) return MUS_MP3;
+    if (SDL_strcasecmp(ext, "ogg") == 0) return MUS_OGG;
+    if (SDL_strcasecmp(ext, "wav") == 0) return MUS_WAV;
+    if (SDL_strcasecmp(ext, "flac") == 0) return MUS_FLAC;
+    return MUS_NONE;
+}
+
+bool AssetPack::open(const std::string& path) {
+    close();
+    if (!file.open(path))
+        return false;
+    const char* base = static_cast<const char*>(file.data());
+    size_t length = file.size();
+
+    // Every entry and name must lie inside the file
+    const PackHeader* h = reinterpret_cast<const PackHeader*>(base);
+    const char* problem = nullptr;
+    if (length < sizeof(PackHeader) || std::memcmp(h->magic, packMagic, 4) != 0)
+        problem = "not an asset pack";
+    else if (h->version != packVersion)
+        problem = "unsupported pack version";
+    else if (h->byteOrder != packByteOrder)
+        problem = "pack was built on a host of the other byte order";
+    else if (h->count > (length - sizeof(PackHeader)) / sizeof(PackEntry) ||
+             h->namesOffset > length || h->namesSize > length - h->namesOffset)
+        problem = "index out of bounds";
+    const PackEntry* table = reinterpret_cast<const PackEntry*>(base + sizeof(PackHeader));
+    for (uint32_t i = 0; !problem && i < h->count; i++) {
+        const PackEntry& e = table[i];
+        if (e.offset > length || e.size > length - e.offset || e.size > INT32_MAX ||
+            e.nameOffset > h->namesSize || e.nameLength > h->namesSize - e.nameOffset)
+            problem = "entry out of bounds";
+    }
+    if (problem) {
+        std::cerr << "Bad asset pack " << path << ": " << problem << "\n";
+        close();
+        return false;
+    }
+    entries = table;
+    names = base + h->namesOffset;
+    count = h->count;
+    std::cout << "Asset pack: " << count << " files, " << length / 1024 << " KB\n";
+    return true;
+}
+
+void AssetPack::close() {
+    file.close();
+    entries = nullptr;
+    names = nullptr;
+    count = 0;
+}
+
+const void* AssetPack::find(const std::string& path, size_t& size) {
+    if (!isOpen()) return nullptr;
+    std::string name = key(path);
+    auto nameOf = [](const PackEntry& e) {
+        return std::string_view(names + e.nameOffset, e.nameLength);
+    };
+    const PackEntry* end = entries + count;
+    const PackEntry* it = std::lower_bound(entries, end, std::string_view(name),
+        [&](const PackEntry& e, std::string_view k) { return nameOf(e) < k; });
+    if (it == end || nameOf(*it) != name)
+        return nullptr;
+    size = static_cast<size_t>(it->size);
+    return static_cast<const char*>(file.data()) + it->offset;
+}
+
+SDL_RWops* AssetPack::openRW(const std::string& path) {
+    size_t size = 0;
+    if (const void* bytes = find(path, size))
+        return SDL_RWFromConstMem(bytes, static_cast<int>(size));
+    if (isOpen())
+        std::cerr << "Not in asset pack, reading loose: " << path << "\n";
+    return SDL_RWFromFile(path.c_str(), "rb");
+}
+
+const void* AssetPack::read(const std::string& path, std::vector<char>& storage, size_t& size) {
+    if (const void* bytes = find(path, size))
+        return bytes;
+    SDL_RWops* rw = openRW(path);
+    if (!rw) return nullptr;
+    Sint64 length = SDL_RWsize(rw);
+    storage.resize(length > 0 ? static_cast<size_t>(length) : 0);
+    size = SDL_RWread(rw, storage.data(), 1, storage.size());
+    SDL_RWclose(rw);
+    if (length < 0 || size != storage.size()) {
+        SDL_SetError("Failed to read %s", path.c_str());
+        return nullptr;
+    }
+    return storage.data();
+}
+
+SDL_Surface* AssetPack::decodeImage(const void* data, size_t size, const std::string& path) {
+    return IMG_LoadTyped_RW(SDL_RWFromConstMem(data, static_cast<int>(size)), 1, extensionOf(path));
+}
+
+Mix_Chunk* AssetPack::decodeSound(const void* data, size_t size) {
+    return Mix_LoadWAV_RW(SDL_RWFromConstMem(data, static_cast<int>(size)), 1);
+}
+
+Mix_Music* AssetPack::loadMusic(const std::string& path) {
+    return Mix_LoadMUSType_RW(openRW(path), musicType(path), 1);
+}
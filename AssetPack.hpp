@@ -0,0 +1,43 @@
+#pragma once
+#include "SDL.h"
+#include "SDL_image.h"
+#include "SDL_mixer.h"
+#include "MappedFile.hpp"
+#include "PackFormat.hpp"
+#include <string>
+#include <vector>
+
+// Game assets from one mapped pack file (built by tools/assetpack), so
+// startup opens one file instead of one per image and sound. Lookups use
+// the path as the configs write it ("Textures/Walls/1.png"); anything not
+// in the pack, or everything if no pack is open, is read loose.
+class AssetPack {
+    static MappedFile file;
+    static const PackEntry* entries;
+    static const char* names;
+    static uint32_t count;
+public:
+    static bool open(const std::string& path);
+    static void close();
+    static bool isOpen() { return file.isOpen(); }
+
+    // The packed bytes in place, or nullptr
+    static const void* find(const std::string& path, size_t& size);
+    // Read-only stream over the packed bytes, else over the loose file;
+    // nullptr if neither. Loaders take ownership with freesrc = 1.
+    static SDL_RWops* openRW(const std::string& path);
+
+    // Whole file: the packed bytes in place, else the loose file read
+    // into storage. nullptr (SDL error set) if neither.
+    static const void* read(const std::string& path, std::vector<char>& storage, size_t& size);
+    // Name as looked up: "./a\\b.png" and "a/b.png" are one file
+    static std::string key(const std::string& path);
+
+    // Images and sounds decode from bytes already read, on any thread
+    // once IMG_Init has run (SDL_image loads its codecs lazily, without
+    // locking). Music streams, so it opens its own stream; main thread
+    // only, as SDL_mixer sets up its decoders on first use.
+    static SDL_Surface* decodeImage(const void* data, size_t size, const std::string& path);
+    static Mix_Chunk* decodeSound(const void* data, size_t size);
+    static Mix_Music* loadMusic(const std::string& path);
+};
@@ -1,4 +1,5 @@
 #include "AudioManager.hpp"
+#include "AssetLoader.hpp"
 #include <fstream>
 #include <string>
 #include <algorithm>
@@ -50,39 +51,45 @@ int computeVolume(float dist)
 
 std::map<std::string, MixChunkPtr> AudioManager::soundEffects{};
 std::map<std::string, MixMusicPtr> AudioManager::musicTracks{};
+bool AudioManager::opened = false;
 void AudioManager::init() {
 
     if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0) {
         printf("SDL_mixer Error: %s\n", Mix_GetError());
+        return;
     }
+    opened = true;
 
     Mix_AllocateChannels(16); // number of simultaneous SFX
 }
 
 void AudioManager::loadSoundEffect(const std::string& name, const std::string& path)
 {
-    Mix_Chunk* chunk = Mix_LoadWAV(path.c_str());
-    if (!chunk) {
-        std::cerr << "Failed to load sound effect: " << path
-                  << " | " << Mix_GetError() << '\n';
-        return;
-    }
-    soundEffects.emplace(name, MixChunkPtr(chunk, Mix_FreeChunk));
+    AssetLoader::sound(path, [name, path](MixChunkPtr chunk) {
+        if (!chunk) {
+            std::cerr << "Failed to load sound effect: " << path
+                      << " | " << Mix_GetError() << '\n';
+            return;
+        }
+        soundEffects.emplace(name, chunk);
+    });
 }
 
 void AudioManager::loadMusic(const std::string& name, const std::string& path)
 {
-    Mix_Music* music = Mix_LoadMUS(path.c_str());
-    if (!music) {
-        std::cerr << "Failed to load music: " << path
-                  << " | " << Mix_GetError() << '\n';
-        return;
-    }
-    musicTracks.emplace(name, MixMusicPtr(music, Mix_FreeMusic));
+    AssetLoader::music(path, [name, path](MixMusicPtr music) {
+        if (!music) {
+            std::cerr << "Failed to load music: " << path
+                      << " | " << Mix_GetError() << '\n';
+            return;
+        }
+        musicTracks.emplace(name, music);
+    });
 }
 
 void AudioManager::loadAllAudios(std::string f)
 {
+    if (!opened) return;
     const char* filePath = f.c_str();
     std::ifstream file(filePath);
     if (!file.is_open()) {
@@ -152,6 +159,7 @@ void AudioManager::loadAllAudios(std::string f)
 
 void AudioManager::playSFX(const std::string& name, int volume)
 {
+    if (!opened) return;
     auto it = soundEffects.find(name);
     if (it == soundEffects.end()) {
         std::cerr << "SFX not found: " << name << "\n";
@@ -171,6 +179,7 @@ void AudioManager::playSFX(const std::string& name, int volume)
 
 void AudioManager::playMusic(const std::string& name, int loop)
 {
+    if (!opened) return;
     auto it = musicTracks.find(name);
     if (it == musicTracks.end()) {
         std::cerr << "Music not found: " << name << "\n";
@@ -188,13 +197,14 @@ void AudioManager::playMusic(const std::string& name, int loop)
     }
 }
 bool AudioManager::musicStopped(){
-    return !Mix_PlayingMusic();
+    return opened && !Mix_PlayingMusic();
 }
 void AudioManager::playSpatialSFX(
     const std::string& name,
     float distance,
     float relativeAngle)
 {
+    if (!opened) return;
     auto it = soundEffects.find(name);
     if (it == soundEffects.end())
         return;
@@ -216,6 +226,7 @@ void AudioManager::playSpatialSFX(
 
 void AudioManager::stopMusic()
 {
+    if (!opened) return;
     if (Mix_PlayingMusic()) {
         Mix_HaltMusic();
     }
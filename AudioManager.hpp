@@ -5,15 +5,12 @@
 #include <memory>
 #ifndef AUDIO_MANAGER_HPP
 #define AUDIO_MANAGER_HPP
-using MixChunkPtr =
-    std::unique_ptr<Mix_Chunk, decltype(&Mix_FreeChunk)>;
-
-using MixMusicPtr =
-    std::unique_ptr<Mix_Music, decltype(&Mix_FreeMusic)>;
+#include "AssetLoader.hpp"
 
 class AudioManager {
     static std::map<std::string, MixChunkPtr> soundEffects;
     static std::map<std::string, MixMusicPtr> musicTracks;
+    static bool opened; // no device (headless or failed init): all calls are no-ops
 public:
     static void init();
     static void loadSoundEffect(const std::string& name, const std::string& path);
@@ -0,0 +1,99 @@
+#include "Collision.hpp"
+#include <cmath>
+
+// Gap left between a stopped box and the tile it ran into, so the next
+// overlap test does not count the shared edge
+static const float skin = 1e-4f;
+
+void CollisionMap::build(int w, int h, const TileFn& isSolid) {
+    width = w;
+    height = h;
+    bits.assign((static_cast<size_t>(w) * h + 63) / 64, 0);
+    for (int y = 0; y < h; y++)
+        for (int x = 0; x < w; x++)
+            if (isSolid(x, y))
+                setSolid(x, y, true);
+}
+
+bool CollisionMap::load(int w, int h, const uint64_t* words, size_t count) {
+    if (count != (static_cast<size_t>(w) * h + 63) / 64) return false;
+    width = w;
+    height = h;
+    bits.assign(words, words + count);
+    return true;
+}
+
+void CollisionMap::setSolid(int x, int y, bool s) {
+    if (x < 0 || y < 0 || x >= width || y >= height) return;
+    size_t t = static_cast<size_t>(y) * width + x;
+    uint64_t mask = 1ull << (t & 63);
+    if (s) bits[t >> 6] |= mask;
+    else   bits[t >> 6] &= ~mask;
+}
+
+int CollisionMap::blockingTile(float cx, float cy, float half) const {
+    // Half-open box [min, max): a box ending exactly on a tile edge
+    // does not touch the next tile
+    int minX = (int)std::floor(cx - half), maxX = (int)std::ceil(cx + half) - 1;
+    int minY = (int)std::floor(cy - half), maxY = (int)std::ceil(cy + half) - 1;
+    for (int ty = minY; ty <= maxY; ty++)
+        for (int tx = minX; tx <= maxX; tx++)
+            if (solid(tx, ty))
+                return (tx < 0 || ty < 0 || tx >= width || ty >= height)
+                    ? offMap : ty * width + tx;
+    return -1;
+}
+
+// Leading edge `lead` moves by `delta` along one axis; [lo, hi) is the
+// box's extent on the other axis. Returns how far it may go. The scan
+// starts at the tile under the leading edge: if that is solid (a door
+// shut on the box) the box may only back out.
+float CollisionMap::sweepAxis(float lead, float delta, float lo, float hi, bool alongX) const {
+    int from = (int)std::floor(lo), to = (int)std::ceil(hi) - 1;
+    auto lineSolid = [&](int line) {
+        for (int k = from; k <= to; k++)
+            if (alongX ? solid(line, k) : solid(k, line))
+                return true;
+        return false;
+    };
+    float target = lead + delta;
+    if (delta > 0.0f) {
+        for (int line = (int)std::floor(lead); line < target; line++)
+            if (lineSolid(line))
+                return std::fmax(0.0f, line - skin - lead);
+    } else if (delta < 0.0f) {
+        for (int line = (int)std::floor(lead); line + 1 > target; line--)
+            if (lineSolid(line))
+                return std::fmin(0.0f, line + 1 + skin - lead);
+    }
+    return delta;
+}
+
+std::pair<float, float> CollisionMap::sweep(float cx, float cy, float reach,
+                                            float half, float dx, float dy) const {
+    if (dx != 0.0f)
+        cx += sweepAxis(dx > 0.0f ? cx + reach : cx - reach, dx,
+                        cy - half, cy + half, true);
+    if (dy != 0.0f) {
+        float y0 = cy;
+        cy += sweepAxis(dy > 0.0f ? cy + reach : cy - reach, dy,
+                        cx - half, cx + half, false);
+        // X was swept against the rows the box covered before this move.
+        // If Y brought a wall corner within reach ahead on X, drop the Y
+        // move, so both moving axes keep their clearance.
+        float extra = dx > 0.0f ? reach - half : half - reach;
+        if (dx != 0.0f && cy != y0 &&
+            sweepAxis(dx > 0.0f ? cx + half : cx - half, extra,
+                      cy - half, cy + half, true) != extra)
+            cy = y0;
+    }
+    return {cx, cy};
+}
+
+void CollisionMap::checkBoxes(const int* ids, int count, const float* x,
+                              const float* y, const float* half, int* hit) const {
+    for (int k = 0; k < count; k++) {
+        int id = ids[k];
+        hit[id] = blockingTile(x[id], y[id], half[id]);
+    }
+}
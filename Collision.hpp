@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Tile solidity as a bitset, one bit per tile: walls, and doors that
+// are not fully open. Doors flip their bit when they finish opening or
+// start closing, so movement never looks at door state. Boxes are
+// axis-aligned squares given by centre and half extent; tiles outside
+// the map are solid.
+class CollisionMap {
+public:
+    using TileFn = std::function<bool(int, int)>;
+
+    void build(int width, int height, const TileFn& isSolid);
+    void setSolid(int x, int y, bool solid);
+    bool solid(int x, int y) const {
+        if (x < 0 || y < 0 || x >= width || y >= height) return true;
+        size_t t = static_cast<size_t>(y) * width + x;
+        return (bits[t >> 6] >> (t & 63)) & 1;
+    }
+
+    // Tile index (y * width + x) of the first solid tile the box
+    // overlaps, row by row; -1 if it is free, offMap past the edge
+    static const int offMap = -2;
+    int blockingTile(float cx, float cy, float half) const;
+
+    // Move the box by (dx, dy) one axis at a time. Each axis stops flush
+    // against the first solid tile it would enter, so a blocked axis
+    // does not stop the other one (wall sliding). Never tunnels, even
+    // past a tile that turned solid under the box. The box reaches
+    // `reach` ahead along the axis it moves on and `half` across it, so
+    // a mover can keep more clearance ahead than it needs to the sides.
+    // Moving on both axes, a Y step that would bring a corner within
+    // `reach` ahead on X is dropped, so the clearance holds diagonally.
+    std::pair<float, float> sweep(float cx, float cy, float reach, float half,
+                                  float dx, float dy) const;
+
+    // Batch test for many movers: for k < count, entity ids[k] is a box
+    // at (x[id], y[id]) with half extent half[id]; hit[id] gets its
+    // blocking tile or -1. Read-only, so callers may split the batch
+    // across threads.
+    void checkBoxes(const int* ids, int count, const float* x, const float* y,
+                    const float* half, int* hit) const;
+
+    int mapWidth() const { return width; }
+
+    // Saved bits, for compiled levels. load() copies (doors flip bits)
+    // and fails if the word count does not fit the size.
+    const std::vector<uint64_t>& words() const { return bits; }
+    bool load(int width, int height, const uint64_t* words, size_t count);
+
+private:
+    float sweepAxis(float lead, float delta, float lo, float hi, bool alongX) const;
+
+    int width = 0, height = 0;
+    std::vector<uint64_t> bits;
+};
@@ -11,116 +11,216 @@ bool Game::canShootEnemy(float dist){
     if(weapons.find(currentWeapon) == weapons.end())
         return false;
     int errorDivisor = ((int) (weapons[currentWeapon].accuracy - 1) * (1.0f - t * t)) + 1;
-    return (rand() % errorDivisor) != 0;
+    return combatRng.range(errorDivisor) != 0;
 }
 
 
-bool Game::rayCastEnemyToPlayer(const Enemy& enemy, bool isPlayer) {
-    float ex = enemy.get_position().first;
-    float ey = enemy.get_position().second;
+void Game::resolveShot(){
+    if(weapons.find(currentWeapon) == weapons.end())
+        return;
 
-    float px = playerPosition.first;
-    float py = playerPosition.second;
+    HitscanWorld world{
+        &Map,
+        [this](int x, int y) -> float {
+            if (!isDoor(Map[y][x])) return -1.0f;
+            const Door* d = doorAt(x, y);
+            return d ? d->openAmount : 0.0f;
+        },
+        &enemyIndex,
+        [this](int id, HitscanTarget& t) {
+            if (enemies.get_isDead(id)) return false;
+            if (enemies.archetype[id] >= enemyVisuals.size()) return false;
+            const EnemyVisuals& visuals = enemyVisuals[enemies.archetype[id]];
+            auto mask = visuals.hitMasks.find(
+                {enemies.get_current_frame(id), enemies.get_dirn_num(id)});
+            t.x = enemies.posX[id];
+            t.y = enemies.posY[id];
+            t.width = (float)visuals.width / visuals.height;
+            t.mask = mask == visuals.hitMasks.end() ? nullptr : &mask->second;
+            return true;
+        }
+    };
 
-    float r = 0.1f;
+    HitscanRay ray;
+    ray.x = playerPosition.first;
+    ray.y = playerPosition.second;
+    ray.angle = playerAngle;
+    ray.range = weapons[currentWeapon].range;
+    ray.minDist = playerSquareSize;
+    ray.boundFraction = enemyBoundBox;
 
-    std::vector<std::pair<float, float>> samplePoints;
-    
-    if(isPlayer){
-        samplePoints = {
-            std::make_pair(ex, ey),
-        };
-    }
-    else{
-        samplePoints = {
-            std::make_pair(ex, ey),
-            std::make_pair(ex+r, ey),
-            std::make_pair(ex, ey+r),
-            std::make_pair(ex-r, ey),
-            std::make_pair(ex, ey-r)
-        };
+    for (const HitscanHit& hit : Hitscan::trace(world, ray)) {
+        auto [x, y] = enemies.get_position(hit.id);
+        int dmg=0;
+        if(canShootEnemy(hit.distance))
+            dmg = (combatRng.next() & 31) * weapons[currentWeapon].multiplier;
+        if (!headless)
+            std::cout << "Enemy at index " << hit.id << " shot for " << dmg << " damage.\n";
+        if(enemies.takeDamage(hit.id, dmg)){
+            spawnRandomAmmoPack(std::make_pair((int)x, (int)y));
+        }
     }
+}
 
-    for(const auto& [x, y] : samplePoints)
-    {
-        // Direction vector
-        float dx = px - x;
-        float dy = py - y;
+// Tiles the player can see, recast only when the player changes tile or
+// a door becomes passable/impassable. Enemies read it in O(1).
+void Game::updatePlayerVisibility() {
+    int px = (int)std::floor(playerPosition.first);
+    int py = (int)std::floor(playerPosition.second);
+    if (visibilityVersion == doorVersion && !playerVisibility.empty() &&
+        px == playerVisibility.originX() && py == playerVisibility.originY())
+        return;
 
-        float rayLength = std::hypot(dx, dy);
-        if (rayLength < 0.0001f)
-            return true;
+    playerVisibility.compute(px, py, mapWidth, (int)Map.size(), sightRadius,
+        [this](int x, int y) {
+            if (x >= (int)Map[y].size()) return true;
+            int tile = Map[y][x];
+            if (tile == 0) return false;
+            if (!isDoor(tile)) return true;
+            const Door* d = doorAt(x, y);
+            return !d || d->openAmount < 1.0f;
+        });
+    visibilityVersion = doorVersion;
+}
 
-        dx /= rayLength;
-        dy /= rayLength;
-
-        // Current grid square
-        int mapX = int(std::floor(x));
-        int mapY = int(std::floor(y));
-
-        int targetX = int(std::floor(px));
-        int targetY = int(std::floor(py));
-
-        // Ray step direction
-        int stepX = (dx < 0) ? -1 : 1;
-        int stepY = (dy < 0) ? -1 : 1;
-
-        // Distance to first grid boundary
-        float sideDistX;
-        float sideDistY;
-
-        float deltaDistX = (dx == 0) ? 1e30f : std::abs(1.0f / dx);
-        float deltaDistY = (dy == 0) ? 1e30f : std::abs(1.0f / dy);
-
-        if (dx < 0)
-            sideDistX = (x - mapX) * deltaDistX;
-        else
-            sideDistX = (mapX + 1.0f - x) * deltaDistX;
-
-        if (dy < 0)
-            sideDistY = (y - mapY) * deltaDistY;
-        else
-            sideDistY = (mapY + 1.0f - y) * deltaDistY;
-
-        // DDA loop
-        while (true) {
-            if (sideDistX < sideDistY) {
-                sideDistX += deltaDistX;
-                mapX += stepX;
-            } else {
-                sideDistY += deltaDistY;
-                mapY += stepY;
-            }
+// Shared chase field toward the player, rebuilt under the same
+// conditions as the visibility field. Closed doors cost extra (the
+// enemy has to stop and open them); locked ones are impassable until
+// the player opens them.
+void Game::updatePlayerFlowField() {
+    int px = (int)std::floor(playerPosition.first);
+    int py = (int)std::floor(playerPosition.second);
+    if (flowVersion == doorVersion && !playerFlow.empty() &&
+        px == playerFlow.goalX() && py == playerFlow.goalY())
+        return;
 
-            // Bounds check
-            if (mapY < 0 || mapY >= (int)Map.size() ||
-                mapX < 0 || mapX >= (int)Map[0].size())
-            {
-                break;
-            }
+    playerFlow.compute(px, py, mapWidth, (int)Map.size(), chaseRadius,
+        [this](int x, int y) {
+            if (x >= (int)Map[y].size()) return -1;
+            int tile = Map[y][x];
+            if (tile == 0) return 1;
+            if (!isDoor(tile)) return -1;
+            const Door* d = doorAt(x, y);
+            if (!d) return -1;
+            if (d->openAmount >= 1.0f) return 1;
+            return d->locked ? -1 : 4;
+        });
+    flowVersion = doorVersion;
+}
 
-            // Hit wall
-            if (Map[mapY][mapX] > 0 && !isDoor(Map[mapY][mapX])){
-                break;
-            }
-            else if (isDoor(Map[mapY][mapX])) {
-                auto doorIt = doors.find({mapX, mapY});
-                if (doorIt != doors.end()) {
-                    Door& door = doorIt->second;
-                    if (door.openAmount < 1.0f){
-                        break;
-                    }
-                } else {
-                    break;
-                }
-            }
+// Room/door graph for enemies chasing past chaseRadius. Locked doors
+// are cut until they stand fully open.
+void Game::buildRouteGraph() {
+    auto tileAt = [this](int x, int y) {
+        return x < (int)Map[y].size() ? Map[y][x] : 1;
+    };
+    routeGraph.build(mapWidth, (int)Map.size(),
+        [&](int x, int y) { return tileAt(x, y) == 0; },
+        [&](int x, int y) { return isDoor(tileAt(x, y)) && doorAt(x, y); },
+        [this](int x, int y) { return doorAt(x, y)->locked; });
+    enemies.routeGraph = &routeGraph;
+    std::cout << "Route graph: " << routeGraph.clusterCount() << " clusters, "
+              << routeGraph.portalCount() << " portals\n";
+}
+
+// Rooms split at doors, for hearing. A door carries sound from the
+// moment it starts opening until it is fully shut again.
+void Game::buildAreaGraph() {
+    auto tileAt = [this](int x, int y) {
+        return x < (int)Map[y].size() ? Map[y][x] : 1;
+    };
+    areas.build(mapWidth, (int)Map.size(),
+        [&](int x, int y) { return tileAt(x, y) == 0; },
+        [&](int x, int y) { return isDoor(tileAt(x, y)) && doorAt(x, y); },
+        [this](int x, int y) { return doorAt(x, y)->openAmount > 0.0f; });
+    initAreaState();
+}
+
+// Area buckets and activity for a freshly built or loaded area graph
+void Game::initAreaState() {
+    enemiesInArea.assign(areas.areaCount(), {});
+    enemyArea.assign(enemies.size(), -1);
+    areaActive.assign(areas.areaCount(), 1);
+    areaVersion++;
+    for (int i = 0; i < enemies.size(); i++)
+        placeEnemyInArea(i);
+    std::cout << "Area graph: " << areas.areaCount() << " areas\n";
+}
 
-            // Reached player cell
-            if (mapX == targetX && mapY == targetY)
-                return true;
+// Keep enemy i in the bucket of the area it stands in
+void Game::placeEnemyInArea(int i) {
+    if (i >= (int)enemyArea.size())
+        enemyArea.resize(enemies.size(), -1);
+    int a = areas.areaAt((int)std::floor(enemies.posX[i]), (int)std::floor(enemies.posY[i]));
+    int old = enemyArea[i];
+    if (a == old) return;
+    if (old >= 0) {
+        auto& bucket = enemiesInArea[old];
+        auto it = std::find(bucket.begin(), bucket.end(), i);
+        if (it != bucket.end()) {
+            *it = bucket.back();
+            bucket.pop_back();
         }
     }
-    return false;
+    enemyArea[i] = a;
+    if (a >= 0)
+        enemiesInArea[a].push_back(i);
+    updateDormancy(i);
+}
+
+// Reflood from the player's area when they change rooms or a door
+// link toggles; otherwise free
+void Game::updateActiveAreas() {
+    int from = areas.areaAt((int)std::floor(playerPosition.first),
+                            (int)std::floor(playerPosition.second));
+    if (from == activeFromArea && activeAreaVersion == areaVersion)
+        return;
+    activeFromArea = from;
+    activeAreaVersion = areaVersion;
+
+    if (from < 0) {
+        std::fill(areaActive.begin(), areaActive.end(), 1); // off the map: wake all
+    } else {
+        std::fill(areaActive.begin(), areaActive.end(), 0);
+        areas.flood(from, heardAreas);
+        for (int a : heardAreas)
+            areaActive[a] = 1;
+    }
+    for (int i = 0; i < enemies.size(); i++)
+        updateDormancy(i);
+}
+
+bool Game::inActiveArea(float x, float y) const {
+    int a = areas.areaAt((int)std::floor(x), (int)std::floor(y));
+    return a < 0 || areaActive[a];
+}
+
+void Game::updateDormancy(int i) {
+    int a = enemyArea[i];
+    bool sleeping = a >= 0 && !areaActive[a] && !enemies.isAlerted(i);
+    enemies.dormant[i] = sleeping;
+    if (sleeping)
+        enemies.updateCanSeePlayer(i, false);
+}
+
+// A noise at (x, y) alerts every living enemy within radius whose
+// room is connected to the source through open doors. Walls and shut
+// doors block it; the cost is per area reached.
+void Game::propagateNoise(float x, float y, float radius) {
+    areas.flood(areas.areaAt((int)std::floor(x), (int)std::floor(y)), heardAreas);
+    nearbyEnemies.clear();
+    for (int a : heardAreas)
+        for (int i : enemiesInArea[a])
+            if (distSq({x, y}, enemies.get_position(i)) <= radius * radius)
+                nearbyEnemies.push_back(i);
+    std::sort(nearbyEnemies.begin(), nearbyEnemies.end());
+    for (int i : nearbyEnemies)
+        if (!enemies.isAlerted(i) && !enemies.get_isDead(i))
+            enemies.alert(i);
+}
+
+bool Game::enemyCanSeePlayer(float ex, float ey) const {
+    return playerVisibility.isVisible((int)std::floor(ex), (int)std::floor(ey));
 }
 
 void Game::acquireWeapon(int weaponType) {
@@ -156,7 +256,7 @@ bool Game::playerHasWeapon(int weaponType) {
 }
 
 void Game::spawnRandomAmmoPack(std::pair<int, int> pos){
-    int type = 3 + (rand() % (weapons.size()>2? 2 : 1));
+    int type = 3 + combatRng.range(weapons.size()>2? 2 : 1);
     auto spawnPoint = pos;
     
     if (Map[pos.second][pos.first] > 0)
@@ -190,10 +290,8 @@ void Game::spawnRandomAmmoPack(std::pair<int, int> pos){
         }
     }
 
-    int spriteID = AllSpriteTextures.size();
-    AmmoPackPositions[{type, spriteID}] = spawnPoint;
-    indexOfSpawnedAmmos.push_back(AllSpriteTextures.size());
-    AllSpriteTextures.push_back(Sprite{ spriteID, spawnPoint, ammoPackTextures[2],
-                 ammoPackWidthsHeights[3].first, ammoPackWidthsHeights[3].second});
-    std::cout << "Spawned ammo pack of type " << type << " at (" << spawnPoint.first << ", " << spawnPoint.second << ")\n";
+    addItem(PickupKind::AMMO, type, spawnPoint.first, spawnPoint.second,
+            ammoPackTextures[2], ammoPackWidthsHeights[3]);
+    if (!headless)
+        std::cout << "Spawned ammo pack of type " << type << " at (" << spawnPoint.first << ", " << spawnPoint.second << ")\n";
 }
\ No newline at end of file
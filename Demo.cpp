@@ -0,0 +1,132 @@
+#include "Demo.hpp"
+#include <iostream>
+#include <iterator>
+
+static const char demoMagic[4] = {'W', '3', 'D', 'M'};
+static const uint16_t demoVersion = 2; // 2: enemy list after the level
+static const size_t recordSize = 5;
+
+// Fixed little endian layout, whatever the host
+static void putBytes(std::string& buf, uint64_t v, int n) {
+    for (int i = 0; i < n; i++)
+        buf.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+}
+
+static uint64_t getBytes(const std::string& buf, size_t& at, int n) {
+    uint64_t v = 0;
+    for (int i = 0; i < n; i++)
+        v |= static_cast<uint64_t>(static_cast<uint8_t>(buf[at + i])) << (8 * i);
+    at += n;
+    return v;
+}
+
+bool Demo::record(const std::string& path, int rate, uint64_t s,
+                  const std::string& lvl, const std::string& enemyList)
+{
+    stop();
+    out.open(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Failed to open demo file for writing: " << path << std::endl;
+        return false;
+    }
+    seed = s;
+    level = lvl;
+    enemies = enemyList;
+    tickRate = rate;
+    ticks = 0;
+
+    std::string header(demoMagic, 4);
+    putBytes(header, demoVersion, 2);
+    putBytes(header, tickRate, 2);
+    putBytes(header, seed, 8);
+    putBytes(header, level.size(), 2);
+    header += level;
+    putBytes(header, enemies.size(), 2);
+    header += enemies;
+    out.write(header.data(), header.size());
+    mode = Mode::RECORD;
+    return true;
+}
+
+bool Demo::play(const std::string& path) {
+    stop();
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "Failed to open demo file: " << path << std::endl;
+        return false;
+    }
+    std::string buf((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    size_t at = 0;
+    if (buf.size() < 18 || buf.compare(0, 4, demoMagic, 4) != 0) {
+        std::cerr << "Not a demo file: " << path << std::endl;
+        return false;
+    }
+    at = 4;
+    uint16_t version = static_cast<uint16_t>(getBytes(buf, at, 2));
+    if (version < 1 || version > demoVersion) {
+        std::cerr << "Unsupported demo version: " << path << std::endl;
+        return false;
+    }
+    tickRate = static_cast<int>(getBytes(buf, at, 2));
+    seed = getBytes(buf, at, 8);
+    size_t levelLength = getBytes(buf, at, 2);
+    if (buf.size() < at + levelLength) {
+        std::cerr << "Truncated demo header: " << path << std::endl;
+        return false;
+    }
+    level = buf.substr(at, levelLength);
+    at += levelLength;
+    enemies.clear();
+    if (version >= 2) {
+        size_t enemiesLength = buf.size() >= at + 2 ? getBytes(buf, at, 2) : 0;
+        if (buf.size() < at + enemiesLength) {
+            std::cerr << "Truncated demo header: " << path << std::endl;
+            return false;
+        }
+        enemies = buf.substr(at, enemiesLength);
+        at += enemiesLength;
+    }
+
+    recorded.clear();
+    while (buf.size() - at >= recordSize) {
+        TickInput t;
+        t.keys = static_cast<uint16_t>(getBytes(buf, at, 2));
+        t.mouseDx = static_cast<int16_t>(getBytes(buf, at, 2));
+        uint8_t presses = static_cast<uint8_t>(getBytes(buf, at, 1));
+        t.clicks = presses & 0x0F;
+        t.uses = presses >> 4;
+        recorded.push_back(t);
+    }
+    ticks = 0;
+    mode = Mode::PLAY;
+    return true;
+}
+
+void Demo::stop() {
+    if (out.is_open())
+        out.close();
+    mode = Mode::OFF;
+}
+
+bool Demo::next(TickInput& in) {
+    if (mode == Mode::PLAY) {
+        if (ticks >= recorded.size())
+            return false;
+        in = recorded[ticks++];
+        return true;
+    }
+    if (mode == Mode::RECORD) {
+        // Presses share one byte; more than 15 in a tick is not a thing
+        // (clamped here too, so the live run matches its playback)
+        if (in.clicks > 15) in.clicks = 15;
+        if (in.uses > 15) in.uses = 15;
+        std::string rec;
+        putBytes(rec, in.keys, 2);
+        putBytes(rec, static_cast<uint16_t>(in.mouseDx), 2);
+        putBytes(rec, in.clicks | (in.uses << 4), 1);
+        out.write(rec.data(), rec.size());
+        ticks++;
+    }
+    return true;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Held keys that drive the simulation, one bit each
+enum InputKey : uint16_t {
+    INPUT_FORWARD      = 1 << 0,
+    INPUT_BACK         = 1 << 1,
+    INPUT_STRAFE_LEFT  = 1 << 2,
+    INPUT_STRAFE_RIGHT = 1 << 3,
+    INPUT_TURN_LEFT    = 1 << 4,
+    INPUT_TURN_RIGHT   = 1 << 5,
+    INPUT_WEAPON_1     = 1 << 6,
+    INPUT_WEAPON_2     = 1 << 7,
+    INPUT_WEAPON_3     = 1 << 8
+};
+
+// Everything handleEvents hands to one simulation tick: keys as held
+// now, plus mouse motion, clicks and use presses since the last tick
+struct TickInput {
+    uint16_t keys = 0;
+    int16_t mouseDx = 0;
+    uint8_t clicks = 0, uses = 0;
+};
+
+// Demo file: a header (magic, version, tick rate, RNG seed, level, enemy
+// list) followed by one 5 byte record per tick. Recording streams to
+// disk; playback reads the whole file up front.
+class Demo {
+public:
+    bool record(const std::string& path, int tickRate, uint64_t seed,
+                const std::string& level, const std::string& enemies);
+    bool play(const std::string& path);
+    void stop();
+
+    bool recording() const { return mode == Mode::RECORD; }
+    bool playing() const { return mode == Mode::PLAY; }
+
+    // Recording: stores in. Playback: replaces in with the next
+    // recorded tick, false once the demo has run out.
+    bool next(TickInput& in);
+
+    uint64_t seed = 0;
+    std::string level;
+    std::string enemies;    // empty in version 1 files: the default list
+    int tickRate = 0;
+    uint32_t ticks = 0;     // ticks recorded or played so far
+
+private:
+    enum class Mode { OFF, RECORD, PLAY };
+    Mode mode = Mode::OFF;
+    std::ofstream out;
+    std::vector<TickInput> recorded;
+};
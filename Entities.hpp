@@ -0,0 +1,102 @@
+#pragma once
+#include <utility>
+#include <vector>
+
+// Entities are plain ids: handed out in order for things that stand in
+// the world (enemies, items, decorations), tile indices for things built
+// into the map (doors). The two spaces never share a store.
+using Entity = int;
+
+// Where a world entity stands, in map units (its centre)
+struct Position {
+    float x = 0.0f, y = 0.0f;
+};
+
+// One component type as a sparse set. Components are packed densely so
+// systems iterate them linearly; a paged entity -> slot table gives O(1)
+// lookup. Pages are only allocated when used, so a large, mostly empty
+// id space (a big map's tiles) stays cheap.
+template <class T>
+class ComponentStore {
+public:
+    bool has(Entity e) const { return slotOf(e) >= 0; }
+
+    T* find(Entity e) {
+        int s = slotOf(e);
+        return s >= 0 ? &items[s] : nullptr;
+    }
+    const T* find(Entity e) const {
+        int s = slotOf(e);
+        return s >= 0 ? &items[s] : nullptr;
+    }
+    T& get(Entity e) { return items[slotOf(e)]; }
+    const T& get(Entity e) const { return items[slotOf(e)]; }
+
+    // Adds, or replaces the entity's component
+    T& add(Entity e, T value) {
+        int s = slotOf(e);
+        if (s >= 0) {
+            items[s] = std::move(value);
+            return items[s];
+        }
+        slotRef(e) = static_cast<int>(items.size());
+        items.push_back(std::move(value));
+        owners.push_back(e);
+        return items.back();
+    }
+
+    // Swap-pop: the last component takes the removed one's slot
+    void remove(Entity e) {
+        int s = slotOf(e);
+        if (s < 0) return;
+        Entity last = owners.back();
+        if (last != e) {
+            items[s] = std::move(items.back());
+            owners[s] = last;
+            slotRef(last) = s;
+        }
+        items.pop_back();
+        owners.pop_back();
+        slotRef(e) = -1;
+    }
+
+    void clear() {
+        items.clear();
+        owners.clear();
+        pages.clear();
+    }
+
+    // Dense access: component k belongs to owner(k)
+    size_t size() const { return items.size(); }
+    bool empty() const { return items.empty(); }
+    T& operator[](size_t k) { return items[k]; }
+    const T& operator[](size_t k) const { return items[k]; }
+    Entity owner(size_t k) const { return owners[k]; }
+    typename std::vector<T>::iterator begin() { return items.begin(); }
+    typename std::vector<T>::iterator end() { return items.end(); }
+    typename std::vector<T>::const_iterator begin() const { return items.begin(); }
+    typename std::vector<T>::const_iterator end() const { return items.end(); }
+
+private:
+    static const int pageBits = 10;
+    static const int pageSize = 1 << pageBits;
+
+    int slotOf(Entity e) const {
+        if (e < 0) return -1;
+        size_t p = static_cast<size_t>(e) >> pageBits;
+        if (p >= pages.size() || pages[p].empty()) return -1;
+        return pages[p][e & (pageSize - 1)];
+    }
+    int& slotRef(Entity e) {
+        size_t p = static_cast<size_t>(e) >> pageBits;
+        if (p >= pages.size())
+            pages.resize(p + 1);
+        if (pages[p].empty())
+            pages[p].assign(pageSize, -1);
+        return pages[p][e & (pageSize - 1)];
+    }
+
+    std::vector<T> items;
+    std::vector<Entity> owners;
+    std::vector<std::vector<int>> pages;
+};
@@ -0,0 +1,69 @@
+#include "FlowField.hpp"
+#include <queue>
+#include <utility>
+
+static const int dirs[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+
+void FlowField::compute(int gx_, int gy_, int w, int h, int maxCost,
+    const CostFn& cost)
+{
+    gx = gx_;
+    gy = gy_;
+    if (w != width || h != height || dist.empty()) {
+        width = w;
+        height = h;
+        dist.assign(static_cast<size_t>(w) * h, -1);
+    }
+    else {
+        for (int idx : reached)
+            dist[idx] = -1;
+    }
+    reached.clear();
+    if (gx < 0 || gy < 0 || gx >= w || gy >= h) return;
+
+    // Costs are small integers, a binary heap is plenty
+    using Node = std::pair<int, int>; // (distance, tile index)
+    std::priority_queue<Node, std::vector<Node>, std::greater<Node>> open;
+    dist[gy * w + gx] = 0;
+    reached.push_back(gy * w + gx);
+    open.push({0, gy * w + gx});
+
+    while (!open.empty()) {
+        auto [d, idx] = open.top();
+        open.pop();
+        if (d != dist[idx]) continue; // stale entry
+        int x = idx % w, y = idx / w;
+
+        for (const auto& dir : dirs) {
+            int nx = x + dir[0], ny = y + dir[1];
+            if (nx < 0 || ny < 0 || nx >= w || ny >= h) continue;
+            int c = cost(nx, ny);
+            if (c < 0) continue;
+            int nd = d + c;
+            if (nd > maxCost) continue;
+            int& cur = dist[ny * w + nx];
+            if (cur < 0 || nd < cur) {
+                if (cur < 0)
+                    reached.push_back(ny * w + nx);
+                cur = nd;
+                open.push({nd, ny * w + nx});
+            }
+        }
+    }
+}
+
+bool FlowField::nextStep(int x, int y, int& nx, int& ny) const {
+    int best = distance(x, y);
+    if (best <= 0) return false; // unreachable, or already at the goal
+    bool found = false;
+    for (const auto& dir : dirs) {
+        int d = distance(x + dir[0], y + dir[1]);
+        if (d >= 0 && d < best) {
+            best = d;
+            nx = x + dir[0];
+            ny = y + dir[1];
+            found = true;
+        }
+    }
+    return found;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <functional>
+#include <vector>
+
+// Distance-to-goal over the tile grid (Dijkstra from one goal tile),
+// shared by every enemy chasing that goal. Enemies step to the
+// neighbouring tile with the smallest distance, so one search serves
+// any number of them.
+class FlowField {
+public:
+    // Cost of entering tile (x, y); < 0 means it cannot be entered
+    using CostFn = std::function<int(int, int)>;
+
+    // Search from (gx, gy) until distances exceed maxCost. Only the tiles
+    // the last search reached are reset, so the cost follows maxCost,
+    // not the map.
+    void compute(int gx, int gy, int width, int height, int maxCost,
+                 const CostFn& cost);
+
+    // -1 if unreachable or outside the searched radius
+    int distance(int x, int y) const {
+        if (x < 0 || y < 0 || x >= width || y >= height) return -1;
+        return dist[y * width + x];
+    }
+    // Neighbour of (x, y) one step closer to the goal
+    bool nextStep(int x, int y, int& nx, int& ny) const;
+
+    int goalX() const { return gx; }
+    int goalY() const { return gy; }
+    bool empty() const { return dist.empty(); }
+
+private:
+    int gx = -1, gy = -1;
+    int width = 0, height = 0;
+    std::vector<int> dist;
+    std::vector<int> reached; // tiles given a distance by the last search
+};
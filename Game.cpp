@@ -1,5 +1,7 @@
 #include "Game.hpp"
 #include "AudioManager.hpp"
+#include "UIManager.hpp"
+#include "JobSystem.hpp"
 
 Game::Game(){
 
@@ -40,12 +42,23 @@ bool Game::playerHasKey(int keyType) {
     }
     return false;
 }
+void Game::seedRandom(uint64_t seed)
+{
+    rngSeed = seed;
+    enemies.reseed(seed);
+    combatRng = Random(seed ^ 0xC0BA700000000000ull);
+    UIManager::seedRandom(seed ^ 0x4D0D000000000000ull);
+}
+
 void Game::clean()
 {
-    enemyTextures.clear();
+    enemyVisuals.clear();
     wallTextures.clear();
     doors.clear();
     enemies.clear();
+    JobSystem::shutdown();
+    UIManager::useTimers(nullptr);
+    UIManager::clearTextCache();
 
     renderer.reset();
     window.reset();
@@ -55,15 +68,21 @@ void Game::clean()
 
 }
 
+// Player and enemies are boxes centred on their positions
 bool Game::collidesWithEnemy(float x, float y) {
-    for (const auto& e : enemies)
+    // Only enemies in cells the player's box could touch
+    float half = playerSquareSize * 0.5f;
+    enemyIndex.queryAABB(x - half - maxEnemySize, y - half - maxEnemySize,
+        x + half + maxEnemySize, y + half + maxEnemySize, nearbyEnemies);
+    for (int i : nearbyEnemies)
     {
-        if (e->get_isDead()) continue;
+        if (enemies.get_isDead(i)) continue;
+        float s = enemies.get_size(i);
         if (aabbIntersect(
-            x, y,
+            x - half, y - half,
             playerSquareSize, playerSquareSize,
-            e->get_position().first, e->get_position().second,
-            e->get_size(), e->get_size()
+            enemies.posX[i] - s * 0.5f, enemies.posY[i] - s * 0.5f,
+            s, s
         )) {
             return true;
         }
@@ -71,85 +90,140 @@ bool Game::collidesWithEnemy(float x, float y) {
     return false;
 }
 
+void Game::openDoor(std::pair<int, int> pos) {
+    Door* d = doorAt(pos);
+    if (!d) return;
+    d->opening = true;
+    activateDoor(pos);
+}
+
+void Game::activateDoor(std::pair<int, int> pos) {
+    Door& d = *doorAt(pos);
+    if (d.active) return;
+    d.active = true;
+    activeDoors.push_back(tileEntity(pos.first, pos.second));
+}
+
+// (Re)arm the auto-close timer
+void Game::scheduleDoorClose(std::pair<int, int> pos) {
+    Door& d = *doorAt(pos);
+    timers.cancel(d.closeTimer);
+    d.closeTimer = timers.schedule(ticksFor(d.openDuration),
+        [this, pos]{ doorCloseDue(pos); });
+}
+
+// Close once nobody stands in the doorway, else wait another period
+void Game::doorCloseDue(std::pair<int, int> pos) {
+    Door* door = doorAt(pos);
+    if (!door) return;
+    Door& d = *door;
+    d.closeTimer = 0;
+    if (d.vacant) {
+        d.closing = true;
+        activateDoor(pos);
+        AudioManager::playSFX("door_close", MIX_MAX_VOLUME);
+    } else {
+        scheduleDoorClose(pos);
+        if (!headless) std::cout<<"Restarting timer\n";
+    }
+}
+
+// Enemy think wake-ups: a full interval after the last think (or the
+// end of a pain or shot), a staggered first one when none is pending
+// (new level, restart)
+void Game::armEnemyThink(int i) {
+    if (i >= (int)enemyThinkTimer.size())
+        enemyThinkTimer.resize(enemies.size(), 0);
+    TimerWheel::TimerId& wake = enemyThinkTimer[i];
+    float delay;
+    if (enemies.thinkRearm[i]) {
+        enemies.thinkRearm[i] = 0;
+        timers.cancel(wake);
+        delay = enemies.statsOf(i).thinkInterval;
+    }
+    else if (enemies.thinkDue[i] || enemies.get_isDead(i) || timers.pending(wake))
+        return;
+    else
+        delay = enemies.firstThinkDelay(i);
+    wake = timers.schedule(ticksFor(delay), [this, i] {
+        if (i < enemies.size())
+            enemies.thinkDue[i] = 1;
+    });
+}
+
+void Game::resetDoors() {
+    for (size_t k = 0; k < doors.size(); k++){
+        Door& d = doors[k];
+        auto pos = tileOf(doors.owner(k));
+        d.openAmount = 0.0f;
+        d.vacant = true;
+        d.opening = false;
+        d.closing = false;
+        d.active = false;
+        timers.cancel(d.closeTimer);
+        d.closeTimer = 0;
+        routeGraph.setDoorBlocked(pos.first, pos.second, d.locked);
+        collision.setSolid(pos.first, pos.second, true);
+        areas.setDoorOpen(pos.first, pos.second, false);
+    }
+    activeDoors.clear();
+    areaVersion++;
+    doorVersion++;
+}
+
+// Would enemy i walking to (x, y) push into another enemy? Moves that
+// separate overlapping enemies are always allowed, so nobody gets stuck.
+bool Game::enemyBlockedByEnemy(int i, float x, float y) const {
+    thread_local std::vector<int> nearby; // called from the job system
+    float s = enemies.get_size(i);
+    enemyIndex.queryAABB(x - maxEnemySize, y - maxEnemySize,
+        x + maxEnemySize, y + maxEnemySize, nearby);
+    for (int j : nearby) {
+        if (j == i || enemies.get_isDead(j)) continue;
+        float reach = 0.5f * (s + enemies.get_size(j));
+        float ox = enemies.posX[j], oy = enemies.posY[j];
+        if (std::fabs(x - ox) >= reach || std::fabs(y - oy) >= reach)
+            continue;
+        float before = (enemies.posX[i] - ox) * (enemies.posX[i] - ox) +
+                       (enemies.posY[i] - oy) * (enemies.posY[i] - oy);
+        float after = (x - ox) * (x - ox) + (y - oy) * (y - oy);
+        if (after < before)
+            return true;
+    }
+    return false;
+}
+
+// Would enemy i walking to (x, y) push into the player? Same rule as
+// above: moving away is always allowed.
+bool Game::enemyBlockedByPlayer(int i, float x, float y) const {
+    float reach = 0.5f * (enemies.get_size(i) + playerSquareSize);
+    float px = playerPosition.first, py = playerPosition.second;
+    if (std::fabs(x - px) >= reach || std::fabs(y - py) >= reach)
+        return false;
+    float before = (enemies.posX[i] - px) * (enemies.posX[i] - px) +
+                   (enemies.posY[i] - py) * (enemies.posY[i] - py);
+    float after = (x - px) * (x - px) + (y - py) * (y - py);
+    return after < before;
+}
+
 void Game::acquireKey(int keyType) {
     if (!playerHasKey(keyType)) {
         keysHeld.push_back(keyType);
-        std::cout << "Acquired key of type: " << keyType << "\n";
+        if (!headless)
+            std::cout << "Acquired key of type: " << keyType << "\n";
         AudioManager::playSFX("pickup", MIX_MAX_VOLUME / 2);
     }
 }
 
-int Game::canMoveTo(
-    float x, float y,
-    float width,
-    std::pair<int,int>& cord)
-{
-    float half = width * 0.5f;
-
-    // Object AABB
-    float objX = x - half;
-    float objY = y - half;
-    float objW = width;
-    float objH = width;
-
-    // Expanded bounds check
-    if (objX < 0 || objY < 0 ||
-        objX + objW >= Map[0].size() ||
-        objY + objH >= Map.size())
-    {
-        return 0;
-    }
-
-    // Tile range overlapped by the AABB
-    int minX = (int)std::floor(objX);
-    int maxX = (int)std::floor(objX + objW);
-    int minY = (int)std::floor(objY);
-    int maxY = (int)std::floor(objY + objH);
-
-    for (int ty = minY; ty <= maxY; ++ty) {
-        for (int tx = minX; tx <= maxX; ++tx) {
-
-            int val = Map[ty][tx];
-            if (val == 0)
-                continue;
-
-            // Tile AABB
-            float tileX = (float)tx;
-            float tileY = (float)ty;
-
-            if (!aabbIntersect(
-                    objX, objY, objW, objH,
-                    tileX, tileY, 1.0f, 1.0f))
-                continue;
-
-            // Wall
-            if (!isDoor(val)) {
-                //std::cout<<"Enemy stopped by wall val="<<val
-                //<<"at ("<<tileX<<", "<<tileY<<")"<<"\n";
-                return 0;
-            }
-
-            // Door
-            auto doorIt = doors.find({tx, ty});
-            if (doorIt != doors.end()) {
-                Door& door = doorIt->second;
-                if (door.openAmount < 1.0f) {
-                    cord = {tx, ty};
-                    //std::cout<<"Enemy stopped by door\n";
-                    return -1;
-                }
-            }
-        }
-    }
-    if (aabbIntersect(
-            playerPosition.first, playerPosition.second,
-            playerSquareSize, playerSquareSize,
-            x, y,
-            width, width
-        )){
-            return 0;
-        }
-    return 1;
+// Rebuilt at map load; doors update their bit as they move
+void Game::buildCollisionMap() {
+    collision.build(mapWidth, (int)Map.size(), [this](int x, int y) {
+        if (x >= (int)Map[y].size()) return true;
+        int tile = Map[y][x];
+        if (tile == 0) return false;
+        const Door* d = doorAt(x, y);
+        return !(isDoor(tile) && d && d->openAmount >= 1.0f);
+    });
 }
 
 SDL_Renderer& Game::getRenderer() {
@@ -3,12 +3,27 @@
 #include "SDL.h"
 #include "SDL_image.h"
 #include "enemy.hpp"
+#include "SpatialHash.hpp"
+#include "Hitscan.hpp"
+#include "Visibility.hpp"
+#include "FlowField.hpp"
+#include "PathGraph.hpp"
+#include "AreaGraph.hpp"
+#include "Collision.hpp"
+#include "TimerWheel.hpp"
+#include "Demo.hpp"
+#include "Entities.hpp"
+#include "TileMap.hpp"
+#include "LevelFile.hpp"
+#include "AssetLoader.hpp"
 #include <iostream>
 #include <vector>
 #include <utility>
 #include <map>
 #include <memory>
 #include <algorithm>
+#include <unordered_map>
+#include <cstdint>
 
 // Utilities
 using SDLWindowPtr =
@@ -17,16 +32,11 @@ using SDLWindowPtr =
 using SDLRendererPtr =
     std::unique_ptr<SDL_Renderer, decltype(&SDL_DestroyRenderer)>;
 
-using SDLTexturePtr = std::shared_ptr<SDL_Texture>;
-
+// Drawable component; the entity's Position says where
 struct Sprite {
-    int spriteID;
-    std::pair<float, float> position;
     SDLTexturePtr texture;
-    int textureWidth;
-    int textureHeight;
-    bool isEnemy = false;
-    bool active = true;
+    int textureWidth = 0;
+    int textureHeight = 0;
 };
 
 inline auto distSq = [](const std::pair<float, float>& a,
@@ -45,8 +55,7 @@ static std::string toLower(const std::string &s) {
 }
 
 enum class GameState{
-    //LOADIN, ADD LATER WHEN U ADD LOADING FROM BINARY
-    //FOR DEPICTING PROGESS BARS
+    LOADING,    // assets decoding, progress bar up
     MAINMENU,
     GAMEPLAY,
     PAUSEMENU,
@@ -65,12 +74,42 @@ public:
     Game();
     ~Game() ;
     void init(const char* title, int xpos, int ypos, int width, int height, bool fullscreen);
+    // Set before init: no window, renderer or audio. Textures load as
+    // size-only handles and render() must not be called.
+    bool headless = false;
     void handleEvents();
     void update(float deltaTime);
+    // Simulation runs at a fixed rate; update() always steps tickDt
+    static constexpr int tickRate = 60;
+    static constexpr float tickDt = 1.0f / tickRate;
+    static uint32_t ticksFor(float seconds) {
+        return static_cast<uint32_t>(std::lround(seconds * tickRate));
+    }
+    TimerWheel timers; // gameplay wake-ups, advanced once per update
+
+    // Input is gathered per frame and applied per tick, through the
+    // demo recorder / player
+    Demo demo;
+    TickInput pendingInput;
+    bool nextTickInput(TickInput& in);
+    void applyInput(const TickInput& in);
+
+    // Every random roll in the simulation comes from a stream seeded
+    // here (enemies, combat, HUD), so a seed + input replays exactly
+    void seedRandom(uint64_t seed);
+    uint64_t rngSeed = 0x5EEDull;
+    Random combatRng;
     void render();
     void clean();
     bool running(){return isRunning;}
+    int enemyCount() const {return enemies.size();}
     void loadMapDataFromFile(std::string filename);
+    // Compiled levels (.w3dl): open maps the file and adds its enemies
+    // (in place of loadEnemies), loadCompiledMap replaces
+    // loadMapDataFromFile. compileLevel writes the loaded level out.
+    bool openCompiledLevel(const std::string& path);
+    void loadCompiledMap();
+    bool compileLevel(const std::string& path);
     void loadColorConfigFromFile(const char* filename);
     void placePlayerAt(float x, float y, float angle);
     void printPlayerPosition();
@@ -78,17 +117,25 @@ public:
     bool isDoor(int tileValue);
     bool playerHasKey(int keyType);
     void loadAllTextures(std::string filePath);
-    void addEnemy(float x, float y, float angle);
-    void loadEnemyTextures(std::string filePath);
+    // Texture loads are queued on AssetLoader; done runs when it arrives
+    using TextureFn = std::function<void(SDLTexturePtr texture, int width, int height)>;
+    void loadTexture(const std::string& filePath, const char* what, TextureFn done);
+    void addEnemy(float x, float y, float angle, int type = 0);
+    void loadEnemyArchetypes(std::string filePath);
+    void loadEnemyArchetypeTextures(std::string base);
+    void loadEnemyTextures(std::string filePath, int archetypeId = 0);
     bool collidesWithEnemy(float x, float y);
+    bool enemyBlockedByEnemy(int i, float x, float y) const;
+    bool enemyBlockedByPlayer(int i, float x, float y) const;
     bool canShootEnemy(float dist);
+    void resolveShot();
     void loadEnemies(std::string filePath);
     void acquireKey(int keyType);
     void loadKeysTexture(const char* filePath);
     void acquireWeapon(int weaponType);
     bool playerHasWeapon(int weaponType);
     void loadWeaponsTexture(const char* filePath);
-    int canMoveTo(float x, float y, float s, std::pair<int, int>&);
+    void buildCollisionMap();
     void loadHealthPackTexture(const char* filePath);
     void loadAmmoPackTexture(const char* filePath);
     void spawnRandomAmmoPack(std::pair<int, int>);
@@ -105,6 +152,7 @@ public:
     void loadExitFrame(const char* filePath);
     bool getMouseCapture() const { return captured_mouse; }
     bool freeMouse() {
+        if (!captured_mouse) return true;
         SDL_ShowCursor(SDL_ENABLE);
         SDL_SetRelativeMouseMode(SDL_FALSE);
         captured_mouse = false;
@@ -124,7 +172,12 @@ private:
     std::pair<float, float> playerPosition, playerPositionOnLoad;
     std::pair<int, int> ScreenHeightWidth;
     std::pair<double, double> playerMoveDirection = {0.0, 0.0};
-    std::vector<std::vector<int>> Map;
+    TileMap Map;
+    LevelFile compiledLevel;             // mapped while a compiled level is loaded
+    std::vector<LevelObject> mapObjects; // pickups and decorations as loaded
+    void clearLevel();
+    bool addMapObject(char token, int x, int y);
+    void finishLevelLoad();
     std::vector<SDLTexturePtr> wallTextures;
     std::vector<int> wallTextureWidths;
     std::vector<int> wallTextureHeights;
@@ -132,10 +185,11 @@ private:
         float openAmount;   // 0 = closed, 1 = fully open
         float transitionSpeed = 1.0f;
         float openDuration = 3.0f;
-        float openTimer = 0.0f;
+        TimerWheel::TimerId closeTimer = 0; // pending auto-close
         bool vacant = true;
-        bool opening;       // opening animation active
-        bool closing;       // closing animation active
+        bool opening = false;  // opening animation active
+        bool closing = false;  // closing animation active
+        bool active = false;   // in activeDoors
         bool locked;        // requires key?
         int keyType;        // 0 = none, 1 = blue, 2 = red, 3 = gold
 
@@ -144,14 +198,44 @@ private:
     float DOOR_SLAB_SIZE  = 0.75f; float doorHitT;
     SDLTexturePtr DOOR_FRAME{nullptr, SDL_DestroyTexture};
     std::pair<int, int> doorFrameWidthHeight;
-    std::map<std::pair<int,int>, Door> doors;  // key: (mapX,mapY)
+    // Map-built entities (doors) are keyed by tile index
+    int mapWidth = 0; // widest row
+    Entity tileEntity(int x, int y) const {
+        return (x < 0 || y < 0 || x >= mapWidth) ? -1 : y * mapWidth + x;
+    }
+    std::pair<int, int> tileOf(Entity e) const { return {e % mapWidth, e / mapWidth}; }
+    ComponentStore<Door> doors;
+    Door* doorAt(int x, int y) { return doors.find(tileEntity(x, y)); }
+    const Door* doorAt(int x, int y) const { return doors.find(tileEntity(x, y)); }
+    Door* doorAt(std::pair<int, int> pos) { return doorAt(pos.first, pos.second); }
+    // Doors cost nothing while at rest: only moving ones are in
+    // activeDoors, and open ones sleep on the timer wheel to auto-close
+    std::vector<Entity> activeDoors;
+    void openDoor(std::pair<int, int> pos);
+    void activateDoor(std::pair<int, int> pos);
+    void scheduleDoorClose(std::pair<int, int> pos);
+    void doorCloseDue(std::pair<int, int> pos);
+    void resetDoors();
     std::vector<int> keysHeld; // keys the player has collected
-    std::vector<std::unique_ptr<Enemy>> enemies;
+    EnemyStore enemies;
     std::vector<std::pair<float, float>> enemyLoadLocations;
-    std::map<std::pair<int, int>, SDLTexturePtr> enemyTextures;
-    std::map<int, int> enemySpriteIDToindex;
-    int enemyTextureWidth = 64;
-    int enemyTextureHeight = 64;
+    // Frame set of one enemy archetype, keyed by (frame, dirn)
+    struct EnemyVisuals {
+        std::map<std::pair<int, int>, SDLTexturePtr> textures;
+        std::map<std::pair<int, int>, HitMask> hitMasks;
+        int width = 64, height = 64;
+    };
+    std::vector<EnemyVisuals> enemyVisuals; // indexed by archetype id
+    SpatialHash enemyIndex; // enemy index by position
+    std::vector<int> nearbyEnemies; // query scratch, main thread only
+    float maxEnemySize = 1.0f;      // widest enemy box, pads queries
+    std::vector<float> enemyMoveX, enemyMoveY; // proposed moves, reused
+    std::vector<float> enemyHalf;              // box half extents, per frame
+    std::vector<int> enemyHit;                 // blocking tile per proposal
+    CollisionMap collision;                    // walls + not fully open doors
+    std::vector<int> enemyLastTileX, enemyLastTileY;
+    std::vector<TimerWheel::TimerId> enemyThinkTimer; // pending think wake-ups
+    void armEnemyThink(int i);
     int health = 100;
 
     // weapon (current)
@@ -167,25 +251,79 @@ private:
     };
     std::map<int, weapon> weapons;
     int currentWeapon = 0;
-    float fireCooldown = 0.2f;
     bool shotThisFrame = false, hasShot = false, weaponChangedThisFrame = false;
-    bool rayCastEnemyToPlayer(const Enemy& enemy, bool isPlayer);
+    void updatePlayerVisibility();
+    void updatePlayerFlowField();
+    void buildRouteGraph();
+    bool enemyCanSeePlayer(float ex, float ey) const;
+    VisibilityField playerVisibility; // tiles seen from the player's tile
+    FlowField playerFlow;             // chase distances to the player's tile
+    int sightRadius = 64;             // enemies farther away never see the player
+    int chaseRadius = 64;             // flow field search bound (cost)
+    PathGraph routeGraph;             // rooms and doors, built at load
+    unsigned doorVersion = 0;         // bumped when a door changes passability
+    unsigned visibilityVersion = ~0u, flowVersion = ~0u;
+
+    // Hearing: noise spreads through rooms linked by open doors
+    AreaGraph areas;
+    std::vector<int> enemyArea;                  // area of each enemy, -1 if none
+    std::vector<std::vector<int>> enemiesInArea; // enemy ids per area
+    std::vector<int> heardAreas;                 // flood scratch
+    void buildAreaGraph();
+    void initAreaState();
+    void placeEnemyInArea(int i);
+    void propagateNoise(float x, float y, float radius);
 
-    std::map<int, std::pair<int, int>> keysPositions, keyWidthsHeights;
+    // Activation: only areas connected to the player's are simulated
+    // and drawn. Idle enemies elsewhere sleep; alerted ones keep going.
+    std::vector<uint8_t> areaActive;   // per area
+    unsigned areaVersion = 0;          // bumped when a door link toggles
+    unsigned activeAreaVersion = ~0u;
+    int activeFromArea = -1;
+    void updateActiveAreas();
+    bool inActiveArea(float x, float y) const;
+    void updateDormancy(int i);
+
+    // Things standing in the world are entities with a Position and a
+    // Sprite. Enemies copy their position in once per tick; items and
+    // decorations stand at their tile centre.
+    Entity nextEntity = 0;
+    int loadedEntityCount = 0;           // entities past this were spawned in play
+    Entity createEntity(float x, float y, Sprite sprite);
+    ComponentStore<Position> positions;
+    ComponentStore<Sprite> sprites;        // drawn
+    ComponentStore<Sprite> hiddenSprites;  // collected, back on restart
+    std::vector<int> drawOrder;            // sprite slots, far to near, per frame
+    void showSprite(Entity e);
+    void hideSprite(Entity e);
+
+    // Every collectable on the level is a pickup component on its
+    // entity. Uncollected ones sit in a spatial hash at their position,
+    // so collection only looks at what is in reach.
+    enum class PickupKind { KEY, WEAPON, HEALTH, AMMO };
+    struct Pickup {
+        PickupKind kind;
+        int type;                  // key/weapon/pack type, as below
+    };
+    ComponentStore<Pickup> pickups;
+    SpatialHash itemIndex;           // uncollected pickups
+    std::vector<int> nearbyItems;    // query scratch
+    void addItem(PickupKind kind, int type, int x, int y,
+                 const SDLTexturePtr& texture, const std::pair<int, int>& wh);
+    void indexPickup(Entity e);
+    void reindexPickups();
+    void collectPickups();
+    bool tryCollect(const Pickup& p, const Position& at);
+    void resetPickups();
+
+    std::map<int, std::pair<int, int>> keyWidthsHeights;
     std::vector<SDLTexturePtr> keysTextures;
-    float keyRadius = 0.25f;
-    std::map<int, int> keyTypeToSpriteID; // B R G
+    float keyRadius = 0.25f; // B R G
 
-    std::map<int, std::pair<int, int>> weaponsPositions, weaponWidthsHeights;
+    std::map<int, std::pair<int, int>> weaponWidthsHeights;
     std::vector<SDLTexturePtr> weaponsTextures;
-    float weaponRadius = 0.25f;
-    std::map<int, int> weaponTypeToSpriteID; // K P S
-
-    // healthPack Type and its index 
-    //(index is nothing but the spriteID)
-    //(there can be multiple pack of same type)
-    std::map<std::pair<int, int>, std::pair<int, int>> HealthPackPositions;
-    
+    float weaponRadius = 0.25f; // K P S
+
     // Keys for the following are health pack type only 
     std::map<int, std::pair<int, int>> healthPackWidthsHeights;
     std::vector<SDLTexturePtr> healthPackTextures; // except vectors ofcourse
@@ -195,23 +333,17 @@ private:
     // H h
 
     // Same Logic for Ammo packs
-    std::map<std::pair<int, int>, std::pair<int, int>> AmmoPackPositions;
-
     // Ammo Pack Types 1 = small (+15 pistol), 2 = large (+10 rifle)
     // 3/4 -> random spawn on enemy death (+5 pistol/rifle)
     std::map<int, std::pair<int, int>> ammoPackWidthsHeights;
     std::vector<SDLTexturePtr> ammoPackTextures;
     std::map<int, int> ammoAmounts = {{1,15}, {2,10}, {3,5}, {4,5}};
     float ammoPackRadius = 0.25f;
-    std::vector<int> indexOfSpawnedAmmos;
     // A a
 
     std::map<char, SDLTexturePtr> DecorationTextures;
     std::map<char, std::pair<int, int>> DecorationTextureWidthsHeights;
 
-    std::vector<Sprite> AllSpriteTextures;
-    std::vector<int> renderOrder; // holds spriteIDs
-
     int musicTrack = 1, numOfTracks = 5;
 
     int switchID = 100;
@@ -219,7 +351,7 @@ private:
     std::map<SwitchState, std::pair<int, int>> exitWH;
     SwitchState currentSwitchState = SwitchState::ON;
 
-    float levelCrossDuration = 1.0f, levelCrossTimer = 0.0f;
+    float levelCrossDuration = 1.0f;
 };
 
 #endif
@@ -0,0 +1,150 @@
+#include "Hitscan.hpp"
+#include <algorithm>
+#include <cmath>
+
+HitMask HitMask::fromSurface(SDL_Surface* surface, Uint8 alphaThreshold) {
+    HitMask mask;
+    if (!surface) return mask;
+
+    SDL_Surface* rgba = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+    if (!rgba) return mask;
+
+    mask.width = rgba->w;
+    mask.height = rgba->h;
+    mask.opaque.assign(static_cast<size_t>(mask.width) * mask.height, false);
+
+    SDL_LockSurface(rgba);
+    const Uint8* pixels = static_cast<const Uint8*>(rgba->pixels);
+    for (int y = 0; y < mask.height; y++) {
+        const Uint8* row = pixels + y * rgba->pitch;
+        for (int x = 0; x < mask.width; x++) {
+            // RGBA32 is byte order R, G, B, A on every platform
+            if (row[x * 4 + 3] >= alphaThreshold)
+                mask.opaque[y * mask.width + x] = true;
+        }
+    }
+    SDL_UnlockSurface(rgba);
+    SDL_FreeSurface(rgba);
+    return mask;
+}
+
+bool HitMask::isOpaque(float u, float v) const {
+    if (width == 0 || height == 0) return false;
+    if (u < 0.0f || u >= 1.0f || v < 0.0f || v >= 1.0f) return false;
+    int x = std::min(static_cast<int>(u * width), width - 1);
+    int y = std::min(static_cast<int>(v * height), height - 1);
+    return opaque[y * width + x];
+}
+
+float Hitscan::wallDistance(const HitscanWorld& world,
+    float ox, float oy, float dx, float dy, float maxDist)
+{
+    const auto& Map = *world.map;
+    int mapX = (int)ox;
+    int mapY = (int)oy;
+
+    float deltaDistX = (dx == 0) ? 1e30f : std::fabs(1.0f / dx);
+    float deltaDistY = (dy == 0) ? 1e30f : std::fabs(1.0f / dy);
+
+    int stepX = (dx < 0) ? -1 : 1;
+    int stepY = (dy < 0) ? -1 : 1;
+    float sideDistX = (dx < 0) ? (ox - mapX) * deltaDistX : (mapX + 1.0f - ox) * deltaDistX;
+    float sideDistY = (dy < 0) ? (oy - mapY) * deltaDistY : (mapY + 1.0f - oy) * deltaDistY;
+
+    int hitSide = 0;
+    while (true) {
+        if (sideDistX < sideDistY) {
+            sideDistX += deltaDistX;
+            mapX += stepX;
+            hitSide = 0;
+        } else {
+            sideDistY += deltaDistY;
+            mapY += stepY;
+            hitSide = 1;
+        }
+
+        float enterDist = (hitSide == 0) ? sideDistX - deltaDistX : sideDistY - deltaDistY;
+        if (enterDist > maxDist)
+            return maxDist;
+
+        if (mapY < 0 || mapY >= (int)Map.size() ||
+            mapX < 0 || mapX >= (int)Map[mapY].size())
+            return enterDist;
+
+        float open = world.doorOpenAmount(mapX, mapY);
+        if (open < 0.0f) {
+            if (Map[mapY][mapX] > 0)
+                return enterDist;
+            continue;
+        }
+
+        // Door slab sits in the middle of the tile (same test as Render.cpp)
+        if ((hitSide == 0 && (sideDistY < sideDistX - deltaDistX / 2)) ||
+            (hitSide == 1 && (sideDistX < sideDistY - deltaDistY / 2)))
+            continue; // leaves the tile before reaching the slab
+
+        float hitDist = (hitSide == 0) ? sideDistX - deltaDistX / 2
+                                       : sideDistY - deltaDistY / 2;
+        float hitX = ox + dx * hitDist;
+        float hitY = oy + dy * hitDist;
+        float local = (hitSide == 0) ? hitY - std::floor(hitY)
+                                     : hitX - std::floor(hitX);
+        if (local >= open)
+            return std::min(hitDist, maxDist);
+    }
+}
+
+std::vector<HitscanHit> Hitscan::trace(const HitscanWorld& world,
+    const HitscanRay& ray)
+{
+    std::vector<HitscanHit> hits;
+    float dx = std::cos(ray.angle);
+    float dy = std::sin(ray.angle);
+
+    float wallDist = wallDistance(world, ray.x, ray.y, dx, dy, ray.range);
+
+    std::vector<int> candidates;
+    // Sprites are at most one tile wide, so half a tile of padding
+    world.targets->queryRay(ray.x, ray.y, dx, dy, wallDist, 0.5f, candidates);
+
+    for (int id : candidates) {
+        HitscanTarget t;
+        if (!world.target(id, t))
+            continue;
+
+        float ex = t.x - ray.x;
+        float ey = t.y - ray.y;
+        float along = ex * dx + ey * dy;
+        float dist = std::sqrt(ex * ex + ey * ey);
+        if (along <= 0.0f || dist < ray.minDist || dist >= ray.range ||
+            along >= wallDist)
+            continue;
+
+        // Signed offset of the sprite centre from the ray; positive
+        // means it is drawn right of the crosshair
+        float lateral = ex * -dy + ey * dx;
+        float half = t.width * 0.5f;
+        if (std::fabs(lateral) >= half)
+            continue;
+
+        if (t.mask) {
+            // Crosshair sits at the vertical centre of the billboard
+            float u = 0.5f - lateral / t.width;
+            if (!t.mask->isOpaque(u, 0.5f))
+                continue;
+        }
+        else if (std::fabs(lateral) >= half * ray.boundFraction) {
+            continue;
+        }
+        hits.push_back({id, dist});
+    }
+
+    std::sort(hits.begin(), hits.end(),
+        [](const HitscanHit& a, const HitscanHit& b) {
+            return a.distance < b.distance;
+        });
+    int keep = std::max(ray.penetration, 1);
+    if ((int)hits.size() > keep)
+        hits.resize(keep);
+    return hits;
+}
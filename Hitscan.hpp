@@ -0,0 +1,59 @@
+#pragma once
+#include "SDL.h"
+#include "SpatialHash.hpp"
+#include "TileMap.hpp"
+#include <functional>
+#include <vector>
+
+// Per-pixel opacity of one enemy frame, built from the PNG alpha so
+// shots only land on the visible part of the sprite.
+struct HitMask {
+    int width = 0;
+    int height = 0;
+    std::vector<bool> opaque;
+
+    static HitMask fromSurface(SDL_Surface* surface, Uint8 alphaThreshold = 128);
+    // u, v in [0,1] across the sprite (u left to right as drawn)
+    bool isOpaque(float u, float v) const;
+};
+
+// What a shot can hit, looked up by id from the spatial index
+struct HitscanTarget {
+    float x, y;              // centre on the map
+    float width;             // billboard width in tiles
+    const HitMask* mask;     // nullptr -> use boundFraction of width
+};
+
+struct HitscanHit {
+    int id;
+    float distance;
+};
+
+// Everything a trace reads from the world. No renderer involved, so a
+// shot resolves the same at any resolution and in headless runs.
+struct HitscanWorld {
+    const TileMap* map;
+    std::function<float(int, int)> doorOpenAmount; // < 0 => not a door
+    const SpatialHash* targets;
+    std::function<bool(int, HitscanTarget&)> target; // false -> ignore id
+};
+
+struct HitscanRay {
+    float x, y;              // origin
+    float angle;             // same convention as playerAngle
+    float range;
+    float minDist = 0.0f;    // ignore targets closer than this
+    float boundFraction = 1.0f;
+    int penetration = 1;     // max targets passed through (>= 1)
+};
+
+class Hitscan {
+public:
+    // Distance along (dx, dy) to the first wall or closed door slab
+    static float wallDistance(const HitscanWorld& world,
+        float ox, float oy, float dx, float dy, float maxDist);
+
+    // Hits ordered near to far, clipped by walls and range
+    static std::vector<HitscanHit> trace(const HitscanWorld& world,
+        const HitscanRay& ray);
+};
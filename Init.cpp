@@ -1,9 +1,29 @@
 #include "Game.hpp"
 #include "AudioManager.hpp"
 #include "MenuManager.hpp"
+#include "JobSystem.hpp"
+#include "UIManager.hpp"
 void Game::init(const char *title, int xpos, int ypos, int width, int height, bool fullscreen)
 {
-    if(SDL_Init(SDL_INIT_EVERYTHING) == 0){
+    if(headless){
+        // Timer and events only; IMG still decodes images for their sizes
+        if(SDL_Init(SDL_INIT_TIMER | SDL_INIT_EVENTS) != 0){
+            SDL_Log("SDL init error: %s", SDL_GetError());
+            isRunning = false;
+            return;
+        }
+        // Decoders up front: images are decoded on worker threads
+        if (!(IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG) & (IMG_INIT_PNG | IMG_INIT_JPG))) {
+            SDL_Log("IMG init error: %s", IMG_GetError());
+            isRunning = false;
+            return;
+        }
+        ScreenHeightWidth = std::make_pair(width, height);
+        // Per-entity event logs would dominate a ticks/s measurement
+        enemies.logEvents = false;
+        isRunning = true;
+    }
+    else if(SDL_Init(SDL_INIT_EVERYTHING) == 0){
         int flags = 0;
         if (!(IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG) & (IMG_INIT_PNG | IMG_INIT_JPG))) {
             SDL_Log("IMG init error: %s", IMG_GetError());
@@ -26,20 +46,18 @@ void Game::init(const char *title, int xpos, int ypos, int width, int height, bo
     } else {
         isRunning = false;
     }
-    int i=0;
-    for(const std::unique_ptr<Enemy>& e : enemies){
-        e->init(static_cast<int>(AllSpriteTextures.size()));
-        AllSpriteTextures.push_back(Sprite{static_cast<int>(AllSpriteTextures.size()), 
-            e->get_position(), nullptr
-            , enemyTextureWidth, enemyTextureHeight,
-            true
-            });
-        enemySpriteIDToindex[e->get_spriteID()] = i;
-        i++;
+    for(int i = 0; i < enemies.size(); i++){
+        // Texture and per-type size are applied in update
+        enemies.init(i, createEntity(enemies.posX[i], enemies.posY[i], Sprite{nullptr, 64, 64}));
+        enemyIndex.insert(i, enemies.posX[i], enemies.posY[i]);
     }
     if(FOV > 80)
         std::cout<<"Warning : Too big FOV, V close to 90 deg\n";
-    AudioManager::init();
-    MenuManager::Init(getRenderer());
+    JobSystem::init();
+    UIManager::useTimers(&timers);
+    if(!headless){
+        AudioManager::init();
+        MenuManager::Init(getRenderer());
+    }
     state = GameState::MAINMENU;
 }
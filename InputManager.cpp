@@ -2,6 +2,9 @@
 #include "UIManager.hpp"
 #include "AudioManager.hpp"
 #include "MenuManager.hpp"
+// Collect input for the coming ticks. Only UI side effects (quit,
+// mouse capture, pause) happen here; everything that changes the
+// simulation waits for applyInput, so a demo can reproduce it.
 void Game::handleEvents()
 {
     SDL_Event event;
@@ -11,6 +14,11 @@ void Game::handleEvents()
         if (event.type == SDL_QUIT)
             isRunning = false;
 
+        // Render targets lost their pixels, baked text runs included
+        if (event.type == SDL_RENDER_TARGETS_RESET ||
+            event.type == SDL_RENDER_DEVICE_RESET)
+            UIManager::clearTextCache();
+
         // Hide cursor and lock on first click
         if (event.type == SDL_MOUSEBUTTONDOWN  && event.button.button == SDL_BUTTON_LEFT)
         {
@@ -18,78 +26,21 @@ void Game::handleEvents()
             SDL_SetRelativeMouseMode(SDL_TRUE);   // capture mouse
             captured_mouse = true;
             //std::cout << "Mouse captured\n";
-            if(!hasShot && weapons.size() > 0){
-                if(weapons[currentWeapon].ammo == 0 && currentWeapon > 1){
-                    std::cout << "Out of ammo!\n";
-                }
-                else{
-                    shotThisFrame = true;
-                    hasShot = true;
-                    fireCooldown = 0.0f;
-                    std::cout << "Fired weapon " << currentWeapon << "\n";
-                    if(currentWeapon > 1){
-                        weapons[currentWeapon].ammo--;
-                    }
-                    AudioManager::playSFX(weapons[currentWeapon].soundName, MIX_MAX_VOLUME);
-                }
-            }
-            else{
-            //    std::cout << "Weapon still cooling down\n";
-            }
+            pendingInput.clicks++;
         }
 
         // Mouse movement → rotate player
         if (event.type == SDL_MOUSEMOTION)
         {
             // event.motion.xrel = delta X since last frame
-            playerAngle += event.motion.xrel * mouseSensitivity;
-            playerAngle = fmod(playerAngle, 2 * PI);
+            int dx = pendingInput.mouseDx + event.motion.xrel;
+            pendingInput.mouseDx = std::clamp(dx, -32768, 32767);
         }
 
         if (event.type == SDL_KEYDOWN && event.key.repeat == 0)
         {
             if (event.key.keysym.scancode == SDL_SCANCODE_SPACE)
-            {
-                int tx = (int)(playerPosition.first  + cos(playerAngle));
-                int ty = (int)(playerPosition.second + sin(playerAngle));
-
-                auto key = std::make_pair(tx, ty);
-                if (doors.count(key)) {
-                    Door& d = doors[key];
-
-                    if (d.locked && !playerHasKey(d.keyType))
-                    {   // Do nothing
-                        std::cout << "Door is locked! Need key type: " << d.keyType << "\n";
-                        std::string name = ""; SDL_Color color;
-                        switch(d.keyType){
-                            case 1:
-                                name = "BLUE";
-                                color= {0, 252, 252, 255};
-                                break;
-                            case 2:
-                                name = "RED";
-                                color= {164, 0, 0, 255};
-                                break;
-                            case 3:
-                                name = "GOLD";
-                                color= {204, 196, 0, 255};
-                                break;
-                            default:
-                                color = {0,0,0,0}; 
-                        }
-                        UIManager::notify("NEED "+name+" KEY TO OPEN", color);
-                    }
-                    else if (d.openAmount == 0.0f){
-                        AudioManager::playSFX("door_open", MIX_MAX_VOLUME);
-                        d.opening = true;
-                    }
-                }
-                else if(Map[ty][tx] == switchID && 
-                    currentSwitchState == SwitchState::ON){
-                    currentSwitchState = SwitchState::OFF;
-                    AudioManager::playSFX("switch", MIX_MAX_VOLUME);
-                }
-            }
+                pendingInput.uses++;
             else if(event.key.keysym.scancode == SDL_SCANCODE_ESCAPE){
                 state = GameState::PAUSEMENU;
                 MenuManager::setMenu(Menu::PAUSE);
@@ -99,56 +50,160 @@ void Game::handleEvents()
 
     }
 
-    // Keyboard movement detection
+    // Keyboard state, as held now
     const Uint8* keystate = SDL_GetKeyboardState(NULL);
+    uint16_t keys = 0;
+    if (keystate[SDL_SCANCODE_W] || keystate[SDL_SCANCODE_UP]) keys |= INPUT_FORWARD;
+    if (keystate[SDL_SCANCODE_S] || keystate[SDL_SCANCODE_DOWN]) keys |= INPUT_BACK;
+    if (keystate[SDL_SCANCODE_A]) keys |= INPUT_STRAFE_LEFT;
+    if (keystate[SDL_SCANCODE_D]) keys |= INPUT_STRAFE_RIGHT;
+    if (keystate[SDL_SCANCODE_LEFT]) keys |= INPUT_TURN_LEFT;
+    if (keystate[SDL_SCANCODE_RIGHT]) keys |= INPUT_TURN_RIGHT;
+    if (keystate[SDL_SCANCODE_1]) keys |= INPUT_WEAPON_1;
+    if (keystate[SDL_SCANCODE_2]) keys |= INPUT_WEAPON_2;
+    if (keystate[SDL_SCANCODE_3]) keys |= INPUT_WEAPON_3;
+    pendingInput.keys = keys;
+}
+
+// Input for this tick: live, or taken from / written to the demo.
+// Presses go to the first tick that runs after them.
+bool Game::nextTickInput(TickInput& in)
+{
+    in = pendingInput;
+    pendingInput.mouseDx = 0;
+    pendingInput.clicks = 0;
+    pendingInput.uses = 0;
+    return demo.next(in);
+}
+
+void Game::applyInput(const TickInput& in)
+{
+    if (in.clicks > 0)
+    {
+        if(!hasShot && weapons.size() > 0){
+            if(weapons[currentWeapon].ammo == 0 && currentWeapon > 1){
+                if (!headless) std::cout << "Out of ammo!\n";
+            }
+            else{
+                shotThisFrame = true;
+                hasShot = true;
+                timers.schedule(ticksFor(weapons[currentWeapon].coolDownTime),
+                    [this]{ hasShot = false; });
+                if (!headless)
+                    std::cout << "Fired weapon " << currentWeapon << "\n";
+                if(currentWeapon > 1){
+                    weapons[currentWeapon].ammo--;
+                }
+                AudioManager::playSFX(weapons[currentWeapon].soundName, MIX_MAX_VOLUME);
+            }
+        }
+        else{
+        //    std::cout << "Weapon still cooling down\n";
+        }
+    }
+
+    if (in.mouseDx != 0)
+    {
+        playerAngle += in.mouseDx * mouseSensitivity;
+        playerAngle = fmod(playerAngle, 2 * PI);
+    }
+
+    for (int u = 0; u < in.uses; u++)
+    {
+        int tx = (int)(playerPosition.first  + cos(playerAngle));
+        int ty = (int)(playerPosition.second + sin(playerAngle));
+
+        auto key = std::make_pair(tx, ty);
+        if (Door* door = doorAt(key)) {
+            Door& d = *door;
+
+            if (d.locked && !playerHasKey(d.keyType))
+            {   // Do nothing
+                if (!headless)
+                    std::cout << "Door is locked! Need key type: " << d.keyType << "\n";
+                std::string name = ""; SDL_Color color;
+                switch(d.keyType){
+                    case 1:
+                        name = "BLUE";
+                        color= {0, 252, 252, 255};
+                        break;
+                    case 2:
+                        name = "RED";
+                        color= {164, 0, 0, 255};
+                        break;
+                    case 3:
+                        name = "GOLD";
+                        color= {204, 196, 0, 255};
+                        break;
+                    default:
+                        color = {0,0,0,0}; 
+                }
+                UIManager::notify("NEED "+name+" KEY TO OPEN", color);
+            }
+            else if (d.openAmount == 0.0f){
+                AudioManager::playSFX("door_open", MIX_MAX_VOLUME);
+                openDoor({tx, ty});
+            }
+        }
+        else if(Map[ty][tx] == switchID && 
+            currentSwitchState == SwitchState::ON){
+            currentSwitchState = SwitchState::OFF;
+            AudioManager::playSFX("switch", MIX_MAX_VOLUME);
+            timers.schedule(ticksFor(levelCrossDuration), [this]{
+                currentSwitchState = SwitchState::ON;
+                state = GameState::GAMEWON;
+                MenuManager::setMenu(Menu::GAME_WON);
+            });
+        }
+    }
 
     playerMoveDirection = {0.0f, 0.0f};
 
     // Forward
-    if (keystate[SDL_SCANCODE_W] || keystate[SDL_SCANCODE_UP]) {
+    if (in.keys & INPUT_FORWARD) {
         playerMoveDirection.first += cos(playerAngle);
         playerMoveDirection.second += sin(playerAngle);
     }
 
     // Backward
-    if (keystate[SDL_SCANCODE_S] || keystate[SDL_SCANCODE_DOWN]) {
+    if (in.keys & INPUT_BACK) {
         playerMoveDirection.first -= cos(playerAngle);
         playerMoveDirection.second -= sin(playerAngle);
     }
 
     // Strafe Left (A)
-    if (keystate[SDL_SCANCODE_A]) {
+    if (in.keys & INPUT_STRAFE_LEFT) {
         playerMoveDirection.first += cos(playerAngle - 3.14159f/2);
         playerMoveDirection.second += sin(playerAngle - 3.14159f/2);
     }
 
     // Strafe Right (D)
-    if (keystate[SDL_SCANCODE_D]) {
+    if (in.keys & INPUT_STRAFE_RIGHT) {
         playerMoveDirection.first += cos(playerAngle + 3.14159f/2);
         playerMoveDirection.second += sin(playerAngle + 3.14159f/2);
     }
 
     // Optional keyboard turning (can keep or remove)
-    if (keystate[SDL_SCANCODE_LEFT])
+    if (in.keys & INPUT_TURN_LEFT)
         playerAngle -= rotationSensitivity;
 
-    if (keystate[SDL_SCANCODE_RIGHT])
+    if (in.keys & INPUT_TURN_RIGHT)
         playerAngle += rotationSensitivity;
 
     // Weapon switching (number keys)
-    if(keystate[SDL_SCANCODE_1]){
+    if(in.keys & INPUT_WEAPON_1){
         if(playerHasWeapon(1)){
             currentWeapon = 1;
             weaponChangedThisFrame = true;
         }
     }
-    if(keystate[SDL_SCANCODE_2]){
+    if(in.keys & INPUT_WEAPON_2){
         if(playerHasWeapon(2)){
             currentWeapon = 2;
             weaponChangedThisFrame = true;
         }
     }
-    if(keystate[SDL_SCANCODE_3]){
+    if(in.keys & INPUT_WEAPON_3){
         if(playerHasWeapon(3)){
             currentWeapon = 3;
             weaponChangedThisFrame = true;
@@ -0,0 +1,101 @@
+#include "JobSystem.hpp"
+#include <algorithm>
+#include <cassert>
+
+std::vector<std::thread> JobSystem::workers;
+std::mutex JobSystem::mutex;
+std::condition_variable JobSystem::wake;
+std::condition_variable JobSystem::done;
+bool JobSystem::stopping = false;
+unsigned JobSystem::generation = 0;
+const JobSystem::RangeFn* JobSystem::job = nullptr;
+int JobSystem::jobCount = 0;
+int JobSystem::jobGrain = 1;
+int JobSystem::chunkCount = 0;
+std::atomic<int> JobSystem::nextChunk{0};
+std::atomic<int> JobSystem::chunksDone{0};
+int JobSystem::busy = 0;
+std::atomic<bool> JobSystem::inUse{false};
+
+void JobSystem::init(int count) {
+    if (!workers.empty()) return;
+    if (count < 0)
+        count = std::max(0, (int)std::thread::hardware_concurrency() - 1);
+    stopping = false;
+    for (int i = 0; i < count; i++)
+        workers.emplace_back(workerLoop);
+}
+
+void JobSystem::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& t : workers)
+        t.join();
+    workers.clear();
+}
+
+void JobSystem::runChunks(const RangeFn& fn) {
+    int c;
+    while ((c = nextChunk.fetch_add(1)) < chunkCount) {
+        int begin = c * jobGrain;
+        fn(begin, std::min(begin + jobGrain, jobCount));
+        chunksDone.fetch_add(1);
+    }
+}
+
+void JobSystem::workerLoop() {
+    unsigned seen = 0;
+    while (true) {
+        const RangeFn* fn;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || (job && generation != seen); });
+            if (stopping) return;
+            seen = generation;
+            fn = job;
+            busy++;
+        }
+        runChunks(*fn);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busy--;
+        }
+        done.notify_all();
+    }
+}
+
+void JobSystem::parallelFor(int count, int grain, const RangeFn& fn) {
+    if (count <= 0) return;
+    grain = std::max(grain, 1);
+    if (workers.empty() || count <= grain) {
+        fn(0, count); // not worth waking anyone
+        return;
+    }
+
+    bool overlapped = inUse.exchange(true);
+    assert(!overlapped && "parallelFor called while another one is running");
+    (void)overlapped;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &fn;
+        jobCount = count;
+        jobGrain = grain;
+        chunkCount = (count + grain - 1) / grain;
+        nextChunk = 0;
+        chunksDone = 0;
+        generation++;
+    }
+    wake.notify_all();
+
+    runChunks(fn);
+
+    // Wait for stragglers; nobody may still hold `fn` when we return
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [] { return chunksDone.load() == chunkCount && busy == 0; });
+    job = nullptr;
+    inUse = false;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small fixed pool of worker threads for data-parallel loops. The
+// calling thread works too, and parallelFor returns only once every
+// chunk has run, so callers see plain fork/join semantics.
+class JobSystem {
+public:
+    using RangeFn = std::function<void(int begin, int end)>;
+
+    // workers < 0 -> one per hardware thread minus the caller
+    static void init(int workers = -1);
+    static void shutdown();
+    static int workerCount() { return static_cast<int>(workers.size()); }
+
+    // fn(begin, end) over [0, count) in chunks of at most `grain`. One
+    // caller at a time: the job slots are shared (asserted in debug builds)
+    static void parallelFor(int count, int grain, const RangeFn& fn);
+
+private:
+    static void workerLoop();
+    static void runChunks(const RangeFn& fn);
+
+    static std::vector<std::thread> workers;
+    static std::mutex mutex;
+    static std::condition_variable wake, done;
+    static bool stopping;
+    static unsigned generation;     // bumped per parallelFor
+    static const RangeFn* job;
+    static int jobCount, jobGrain, chunkCount;
+    static std::atomic<int> nextChunk, chunksDone;
+    static int busy;                // workers holding the current job
+    static std::atomic<bool> inUse; // a parallelFor is handing out chunks
+};
@@ -0,0 +1,119 @@
+#include "LevelFile.hpp"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+
+static const char levelMagic[4] = {'W', '3', 'D', 'L'};
+static const uint16_t byteOrderMark = 0x0102;
+static const size_t sectionAlign = 8;
+
+bool LevelFile::isCompiled(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[4];
+    return in.read(magic, 4) && std::memcmp(magic, levelMagic, 4) == 0;
+}
+
+bool LevelFile::open(const std::string& path) {
+    close();
+    if (!file.open(path))
+        return false;
+    base = file.data();
+    length = file.size();
+
+    // Everything the loader will index must lie inside the file
+    const char* problem = nullptr;
+    if (length < sizeof(Header) || std::memcmp(header().magic, levelMagic, 4) != 0)
+        problem = "not a compiled level";
+    else if (header().version != version)
+        problem = "unsupported level version";
+    else if (header().byteOrder != byteOrderMark)
+        problem = "level was compiled on a host of the other byte order";
+    else if (header().width <= 0 || header().height <= 0)
+        problem = "bad map size";
+    for (int s = 0; !problem && s < LEVEL_SECTION_COUNT; s++) {
+        const SectionEntry& e = header().sections[s];
+        if (e.count == 0) continue;
+        if (e.offset % sectionAlign != 0 || e.offset > length || e.elemSize == 0 ||
+            e.count > (length - e.offset) / e.elemSize)
+            problem = "section out of bounds";
+    }
+    // Without a full grid nothing else in the file can be placed
+    if (!problem) {
+        const SectionEntry& t = header().sections[LEVEL_TILES];
+        if (t.elemSize != 1 ||
+            t.count != static_cast<uint64_t>(header().width) * static_cast<uint64_t>(header().height))
+            problem = "tile grid does not match the map size";
+    }
+    if (problem) {
+        std::cerr << "Bad level " << path << ": " << problem << "\n";
+        close();
+        return false;
+    }
+    return true;
+}
+
+void LevelFile::close() {
+    file.close();
+    base = nullptr;
+    length = 0;
+}
+
+const void* LevelFile::rawSection(LevelSection s, size_t elemSize, size_t& count) const {
+    const SectionEntry& e = header().sections[s];
+    if (!base || e.count == 0 || e.elemSize != elemSize) {
+        count = 0;
+        return nullptr;
+    }
+    count = static_cast<size_t>(e.count);
+    return static_cast<const char*>(base) + e.offset;
+}
+
+LevelFile::Writer::Writer(int w, int h, int areas)
+    : width(w), height(h), areaCount(areas),
+      data(LEVEL_SECTION_COUNT, nullptr), counts(LEVEL_SECTION_COUNT, 0),
+      elemSizes(LEVEL_SECTION_COUNT, 0) {}
+
+void LevelFile::Writer::addRaw(LevelSection s, const void* items, size_t count, size_t elemSize) {
+    data[s] = items;
+    counts[s] = count;
+    elemSizes[s] = static_cast<uint32_t>(elemSize);
+}
+
+bool LevelFile::Writer::write(const std::string& path) const {
+    Header h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, levelMagic, 4);
+    h.version = version;
+    h.byteOrder = byteOrderMark;
+    h.width = width;
+    h.height = height;
+    h.areaCount = areaCount;
+
+    uint64_t offset = (sizeof(Header) + sectionAlign - 1) / sectionAlign * sectionAlign;
+    for (int s = 0; s < LEVEL_SECTION_COUNT; s++) {
+        if (counts[s] == 0) continue;
+        h.sections[s] = {offset, counts[s], elemSizes[s], 0};
+        offset += (counts[s] * elemSizes[s] + sectionAlign - 1) / sectionAlign * sectionAlign;
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Failed to open level for writing: " << path << "\n";
+        return false;
+    }
+    static const char zeros[sectionAlign] = {};
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    out.write(zeros, (sectionAlign - sizeof(h) % sectionAlign) % sectionAlign);
+    for (int s = 0; s < LEVEL_SECTION_COUNT; s++) {
+        if (counts[s] == 0) continue;
+        size_t bytes = static_cast<size_t>(counts[s] * elemSizes[s]);
+        out.write(static_cast<const char*>(data[s]), bytes);
+        out.write(zeros, (sectionAlign - bytes % sectionAlign) % sectionAlign);
+    }
+    if (!out) {
+        std::cerr << "Failed to write level: " << path << "\n";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include "MappedFile.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Compiled level (.w3dl): a header with a section table, then plain
+// arrays, each 8-byte aligned, in the writer's byte order. The game maps
+// the file and reads the arrays in place, so loading does no parsing;
+// tables that change at run time (doors, pickups) are copied out.
+// Precomputed sections are optional: if absent the game builds them.
+
+enum LevelSection {
+    LEVEL_TILES,            // uint8_t per tile, width * height
+    LEVEL_DOORS,            // LevelDoor
+    LEVEL_OBJECTS,          // LevelObject: pickups and decorations
+    LEVEL_ENEMIES,          // LevelEnemy
+    LEVEL_ENEMY_TYPES,      // archetype names, '\0' separated
+    LEVEL_COLLISION,        // uint64_t words of CollisionMap bits
+    LEVEL_AREA_TILES,       // int32_t area per tile
+    LEVEL_AREA_LINKS,       // AreaGraph::SavedLink
+    LEVEL_ROUTE_TILES,      // int32_t route cluster per tile
+    LEVEL_ROUTE_CLUSTERS,   // PathGraph::SavedCluster
+    LEVEL_ROUTE_MEMBERS,    // int32_t portal ids, grouped by cluster
+    LEVEL_ROUTE_NODES,      // PathGraph::SavedNode
+    LEVEL_ROUTE_EDGES,      // PathGraph::SavedEdge
+    LEVEL_ROUTE_DOORS,      // PathGraph::SavedDoor
+    LEVEL_SECTION_COUNT
+};
+
+struct LevelDoor {
+    int32_t tile;           // y * width + x
+    uint8_t locked;
+    uint8_t keyType;
+    uint16_t pad;
+};
+
+struct LevelObject {
+    int32_t tile;
+    char token;             // the map file's letter for it
+    uint8_t pad[3];
+};
+
+struct LevelEnemy {
+    float x, y;
+    int32_t type;           // index into LEVEL_ENEMY_TYPES
+};
+
+class LevelFile {
+public:
+    static const uint16_t version = 1;
+
+    LevelFile() = default;
+    LevelFile(const LevelFile&) = delete;
+    LevelFile& operator=(const LevelFile&) = delete;
+    ~LevelFile() { close(); }
+
+    // True if the file starts with the compiled level magic
+    static bool isCompiled(const std::string& path);
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return base != nullptr; }
+
+    int width() const { return header().width; }
+    int height() const { return header().height; }
+    int areaCount() const { return header().areaCount; }
+
+    // Array of a section in place, or nullptr (count 0) if absent
+    template <class T>
+    const T* section(LevelSection s, size_t& count) const {
+        return static_cast<const T*>(rawSection(s, sizeof(T), count));
+    }
+
+    // Writing: collect sections, then write them out in one go. Data
+    // is not copied and must stay valid until write().
+    class Writer {
+    public:
+        Writer(int width, int height, int areaCount);
+        template <class T>
+        void add(LevelSection s, const T* items, size_t count) {
+            addRaw(s, items, count, sizeof(T));
+        }
+        bool write(const std::string& path) const;
+
+    private:
+        void addRaw(LevelSection s, const void* items, size_t count, size_t elemSize);
+        int width, height, areaCount;
+        std::vector<const void*> data;
+        std::vector<uint64_t> counts;
+        std::vector<uint32_t> elemSizes;
+    };
+
+private:
+    struct SectionEntry {
+        uint64_t offset;
+        uint64_t count;
+        uint32_t elemSize;
+        uint32_t pad;
+    };
+    struct Header {
+        char magic[4];
+        uint16_t version;
+        uint16_t byteOrder;     // 0x0102 as written by this host's order
+        int32_t width, height;
+        int32_t areaCount;
+        int32_t pad;
+        SectionEntry sections[LEVEL_SECTION_COUNT];
+    };
+
+    const Header& header() const { return *static_cast<const Header*>(base); }
+    const void* rawSection(LevelSection s, size_t elemSize, size_t& count) const;
+
+    MappedFile file;
+    const void* base = nullptr;
+    size_t length = 0;
+};
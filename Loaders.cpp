@@ -1,6 +1,60 @@
 #include "Game.hpp"
+#include "AssetLoader.hpp"
+#include <cmath>
+#include <cstring>
 #include <fstream>
 #include <sstream>
+#include <type_traits>
+// Forget the current level (text or compiled) before loading another
+void Game::clearLevel()
+{
+    Map.clear();
+    mapObjects.clear();
+    doors.clear();
+    activeDoors.clear();
+    timers.clear();
+    doorVersion++;
+    pickups.clear();
+    itemIndex.clear();
+    mapWidth = 0; // tile entities wait until the map is complete
+}
+
+// Pickups and decorations: a sprite standing on floor tile (x, y).
+// False if the token is neither.
+bool Game::addMapObject(char token, int x, int y)
+{
+    auto pickup = [&](PickupKind kind, int type, const SDLTexturePtr& texture,
+                      const std::pair<int, int>& wh) {
+        addItem(kind, type, x, y, texture, wh);
+    };
+    switch (token) {
+    // Keys
+    case 'B': pickup(PickupKind::KEY, 1, keysTextures[0], keyWidthsHeights[1]); break;
+    case 'R': pickup(PickupKind::KEY, 2, keysTextures[1], keyWidthsHeights[2]); break;
+    case 'G': pickup(PickupKind::KEY, 3, keysTextures[2], keyWidthsHeights[3]); break;
+    // Weapons
+    case 'K': pickup(PickupKind::WEAPON, 1, weaponsTextures[0], weaponWidthsHeights[1]); break;
+    case 'P': pickup(PickupKind::WEAPON, 2, weaponsTextures[1], weaponWidthsHeights[2]); break;
+    case 'S': pickup(PickupKind::WEAPON, 3, weaponsTextures[2], weaponWidthsHeights[3]); break;
+    // Health packs and ammo
+    case 'h': pickup(PickupKind::HEALTH, 1, healthPackTextures[0], healthPackWidthsHeights[1]); break;
+    case 'H': pickup(PickupKind::HEALTH, 2, healthPackTextures[1], healthPackWidthsHeights[2]); break;
+    case 'a': pickup(PickupKind::AMMO, 1, ammoPackTextures[0], ammoPackWidthsHeights[1]); break;
+    case 'A': pickup(PickupKind::AMMO, 2, ammoPackTextures[1], ammoPackWidthsHeights[2]); break;
+    default: {
+        // All other letters with a texture are decoratives
+        auto it = DecorationTextures.find(token);
+        if (it == DecorationTextures.end())
+            return false;
+        createEntity(x + 0.5f, y + 0.5f, Sprite{it->second,
+            DecorationTextureWidthsHeights[token].first,
+            DecorationTextureWidthsHeights[token].second});
+    }
+    }
+    mapObjects.push_back(LevelObject{y * mapWidth + x, token, {}});
+    return true;
+}
+
 void Game::loadMapDataFromFile(std::string filename)
 {
     std::ifstream file(filename);
@@ -9,141 +63,44 @@ void Game::loadMapDataFromFile(std::string filename)
         return;
     }
 
-    Map.clear();
-    doors.clear();
+    clearLevel();
+    compiledLevel.close();
+    std::vector<std::pair<std::pair<int, int>, Door>> loadedDoors;
+    std::vector<std::pair<char, std::pair<int, int>>> loadedObjects;
 
+    std::vector<std::vector<uint8_t>> rows;
     std::string line;
     size_t rowIndex = 0;
 
     while (std::getline(file, line)) {
-        std::vector<int> row;
+        std::vector<uint8_t> row;
         std::istringstream iss(line);
         std::string token;
 
         while (iss >> token) {                 // space-separated
-            // Key handling
-            //std::cout<<token<<"\n";
-            if(token == "B"){
-                keysPositions[1] = {row.size(), rowIndex};
-                keyTypeToSpriteID[1] = AllSpriteTextures.size();
-                AllSpriteTextures.push_back(Sprite{ static_cast<int>(AllSpriteTextures.size()), std::pair<float, float>{row.size(), rowIndex}, keysTextures[0],
-                 keyWidthsHeights[1].first, keyWidthsHeights[1].second});
-                row.push_back(0);
-                continue;
-            }
-            else if(token == "R"){
-                keysPositions[2] = {row.size(), rowIndex};
-                keyTypeToSpriteID[2] = AllSpriteTextures.size();
-                AllSpriteTextures.push_back(Sprite{ static_cast<int>(AllSpriteTextures.size()), std::pair<float, float>{row.size(), rowIndex}, keysTextures[1],
-                 keyWidthsHeights[2].first, keyWidthsHeights[2].second});
-                row.push_back(0);
-                continue;
-            }
-            else if(token == "G"){
-                keysPositions[3] = {row.size(), rowIndex};
-                keyTypeToSpriteID[3] = AllSpriteTextures.size();
-                AllSpriteTextures.push_back(Sprite{ static_cast<int>(AllSpriteTextures.size()), std::pair<float, float>{row.size(), rowIndex}, keysTextures[2], 
-                 keyWidthsHeights[3].first, keyWidthsHeights[3].second});
-                row.push_back(0);
-                continue;
-            }
-
-            // Weapon handling
-            if(token == "K"){
-                weaponsPositions[1] = {row.size(), rowIndex};
-                weaponTypeToSpriteID[1] = AllSpriteTextures.size();
-                AllSpriteTextures.push_back(Sprite{ static_cast<int>(AllSpriteTextures.size()), std::pair<float, float>{row.size(), rowIndex}, weaponsTextures[0],
-                 weaponWidthsHeights[1].first, weaponWidthsHeights[1].second});
-                row.push_back(0);
-                continue;
-            }
-            else if(token == "P"){
-                weaponsPositions[2] = {row.size(), rowIndex};
-                weaponTypeToSpriteID[2] = AllSpriteTextures.size();
-                AllSpriteTextures.push_back(Sprite{ static_cast<int>(AllSpriteTextures.size()), std::pair<float, float>{row.size(), rowIndex}, weaponsTextures[1],
-                 weaponWidthsHeights[2].first, weaponWidthsHeights[2].second});
-                row.push_back(0);
-                continue;
-            }
-            else if(token == "S"){
-                weaponsPositions[3] = {row.size(), rowIndex};
-                weaponTypeToSpriteID[3] = AllSpriteTextures.size();
-                AllSpriteTextures.push_back(Sprite{ static_cast<int>(AllSpriteTextures.size()), std::pair<float, float>{row.size(), rowIndex}, weaponsTextures[2],
-                 weaponWidthsHeights[3].first, weaponWidthsHeights[3].second});
-                row.push_back(0);
-                continue;
-            }
-            
-            // Health Pack handling
-            if(token == "h"){
-                int spriteID = AllSpriteTextures.size();
-                HealthPackPositions[{1, spriteID}] = {row.size(), rowIndex};
-
-                AllSpriteTextures.push_back(Sprite{ static_cast<int>(spriteID), std::pair<float, float>{row.size(), rowIndex}, healthPackTextures[0],
-                 healthPackWidthsHeights[1].first, healthPackWidthsHeights[1].second});
-                row.push_back(0);
-                continue;
-            }
-            else if(token == "H"){
-                int spriteID = AllSpriteTextures.size();
-                HealthPackPositions[{2, spriteID}] = {row.size(), rowIndex};
-                
-                AllSpriteTextures.push_back(Sprite{ static_cast<int>(AllSpriteTextures.size()), std::pair<float, float>{row.size(), rowIndex}, healthPackTextures[1],
-                 healthPackWidthsHeights[2].first, healthPackWidthsHeights[2].second});
-                row.push_back(0);
-                continue;
-            }
-
-            // Handling Ammos
-            if(token == "a"){
-                int spriteID = AllSpriteTextures.size();
-                AmmoPackPositions[{1, spriteID}] = {row.size(), rowIndex};
-                AllSpriteTextures.push_back(Sprite{ spriteID, std::pair<float, float>{row.size(), rowIndex}, ammoPackTextures[0],
-                 ammoPackWidthsHeights[1].first, ammoPackWidthsHeights[1].second});
-                row.push_back(0);
-                continue;
-            }
-            else if(token == "A"){
-                int spriteID = AllSpriteTextures.size();
-                AmmoPackPositions[{2, spriteID}] = {row.size(), rowIndex};
-                AllSpriteTextures.push_back(Sprite{ spriteID, std::pair<float, float>{row.size(), rowIndex}, ammoPackTextures[1],
-                 ammoPackWidthsHeights[2].first, ammoPackWidthsHeights[2].second});
-                row.push_back(0);
-                continue;
-            }
-                
+            // Keys, weapons, pickups and decorations: added once the
+            // width is known, since pickups are keyed by tile
+            char x = token.size() == 1 ? token[0] : '0';
             if (token == "E"){
                 token = std::to_string(switchID);
-                std::cout<<token<<'\n';
             }
-            // All other alphabets are taken as decoratives
-            char x = '0';
-            if(token.size()==1)
-                x = token.c_str()[0];
-            if((x >= 'a' && x <= 'z') || (x >= 'A' && x <= 'Z')){
-                if (DecorationTextures.find(x) != DecorationTextures.end()) {
-                    int spriteID = AllSpriteTextures.size();
-                    AllSpriteTextures.push_back(
-                        Sprite{
-                            spriteID, 
-                            std::pair<float, float>{row.size(), rowIndex},
-                            DecorationTextures[x],
-                            DecorationTextureWidthsHeights[x].first,
-                            DecorationTextureWidthsHeights[x].second,
-                        }
-                    );
-                    row.push_back(0);
-                    continue;
-                }
+            else if ((x >= 'a' && x <= 'z') || (x >= 'A' && x <= 'Z')) {
+                loadedObjects.push_back({x, {(int)row.size(), (int)rowIndex}});
+                row.push_back(0);
+                continue;
             }
             int value;
             try{
                 value = std::stoi(token);      // parses 10, 12, etc.
             }
-            catch(const std::runtime_error& e){
+            catch(const std::exception& e){
                 std::cout << "Can't load map, erroneous data\n"<< e.what() << std::endl;
                 continue;
             }
+            if (value < 0 || value > 255) {
+                std::cerr << "Tile value out of range: " << value << "\n";
+                value = 1;
+            }
             // Door handling
             if (value >= 6 && value <= 9) {
                 Door d;
@@ -155,15 +112,204 @@ void Game::loadMapDataFromFile(std::string filename)
                 if (value == 8) { d.locked = true;  d.keyType = 2; }
                 if (value == 9) { d.locked = true;  d.keyType = 3; }
 
-                doors[{ row.size(), rowIndex }] = d;
+                loadedDoors.push_back({{ (int)row.size(), (int)rowIndex }, d});
             }
 
             row.push_back(value);
         }
 
-        Map.push_back(row);
+        rows.push_back(std::move(row));
         rowIndex++;
     }
+
+    // Flatten; short rows are padded with wall
+    for (const auto& row : rows)
+        mapWidth = std::max(mapWidth, (int)row.size());
+    std::vector<uint8_t> grid(static_cast<size_t>(mapWidth) * rows.size(), 1);
+    for (size_t y = 0; y < rows.size(); y++)
+        std::copy(rows[y].begin(), rows[y].end(), grid.begin() + y * mapWidth);
+    Map.assign(mapWidth, (int)rows.size(), std::move(grid));
+
+    for (const auto& [pos, d] : loadedDoors)
+        doors.add(tileEntity(pos.first, pos.second), d);
+    for (const auto& [token, pos] : loadedObjects)
+        if (!addMapObject(token, pos.first, pos.second))
+            std::cerr << "Unknown map token: " << token << "\n";
+    buildCollisionMap();
+    buildRouteGraph();
+    buildAreaGraph();
+    finishLevelLoad();
+}
+
+// Shared tail of both level loaders
+void Game::finishLevelLoad()
+{
+    loadedEntityCount = nextEntity;
+}
+
+bool Game::openCompiledLevel(const std::string& path)
+{
+    clearLevel(); // the old grid may be a view into the old mapping
+    if (!compiledLevel.open(path))
+        return false;
+    size_t count = 0, nameBytes = 0;
+    const LevelEnemy* spawns = compiledLevel.section<LevelEnemy>(LEVEL_ENEMIES, count);
+    const char* names = compiledLevel.section<char>(LEVEL_ENEMY_TYPES, nameBytes);
+
+    // Archetype names are stored, not ids, so enemyTypes.txt may change
+    std::vector<int> typeIds;
+    for (size_t at = 0; at < nameBytes; ) {
+        size_t len = strnlen(names + at, nameBytes - at);
+        std::string name(names + at, len);
+        int type = enemies.findArchetype(name);
+        if (type < 0) {
+            std::cerr << "Unknown enemy type '" << name
+                      << "', using " << enemies.archetypes[0].name << '\n';
+            type = 0;
+        }
+        typeIds.push_back(type);
+        at += len + 1;
+    }
+    // Spawns index the map unchecked later, so bad ones are dropped here
+    float w = (float)compiledLevel.width(), h = (float)compiledLevel.height();
+    for (size_t i = 0; i < count; i++) {
+        float x = spawns[i].x, y = spawns[i].y;
+        if (!std::isfinite(x) || !std::isfinite(y) ||
+            x < 0.0f || y < 0.0f || x >= w || y >= h) {
+            std::cerr << "Skipping enemy spawn " << i << " outside the map\n";
+            continue;
+        }
+        int32_t t = spawns[i].type;
+        int type = (t >= 0 && t < (int32_t)typeIds.size()) ? typeIds[t] : 0;
+        enemyLoadLocations.push_back(std::make_pair(x, y));
+        addEnemy(x, y, 0.0f, type);
+    }
+    return true;
+}
+
+// The arrays are used where they lie in the mapping; only what changes
+// while playing (doors, pickups, collision bits) is copied out.
+// Precomputed graphs are loaded when present, built otherwise.
+void Game::loadCompiledMap()
+{
+    if (!compiledLevel.isOpen()) {
+        std::cerr << "No compiled level open\n";
+        return;
+    }
+    clearLevel();
+
+    int w = compiledLevel.width(), h = compiledLevel.height();
+    size_t tileCount = static_cast<size_t>(w) * h, count = 0;
+    const uint8_t* tiles = compiledLevel.section<uint8_t>(LEVEL_TILES, count);
+    if (!tiles || count != tileCount) {
+        std::cerr << "Compiled level has no tile grid\n";
+        return;
+    }
+    Map.view(w, h, tiles);
+    mapWidth = w;
+
+    const LevelDoor* levelDoors = compiledLevel.section<LevelDoor>(LEVEL_DOORS, count);
+    for (size_t i = 0; i < count; i++) {
+        if (levelDoors[i].tile < 0 || (size_t)levelDoors[i].tile >= tileCount) continue;
+        Door d;
+        d.openAmount = 0.0f;
+        d.opening = false;
+        d.locked = levelDoors[i].locked != 0;
+        d.keyType = levelDoors[i].keyType;
+        doors.add(levelDoors[i].tile, d);
+    }
+    const LevelObject* objects = compiledLevel.section<LevelObject>(LEVEL_OBJECTS, count);
+    for (size_t i = 0; i < count; i++) {
+        auto [x, y] = tileOf(objects[i].tile);
+        if (objects[i].tile >= 0 && (size_t)objects[i].tile < tileCount)
+            addMapObject(objects[i].token, x, y);
+    }
+
+    const uint64_t* bits = compiledLevel.section<uint64_t>(LEVEL_COLLISION, count);
+    if (!bits || !collision.load(w, h, bits, count))
+        buildCollisionMap();
+
+    PathGraph::Saved route;
+    auto copy = [&](auto& out, LevelSection s) {
+        using T = typename std::decay_t<decltype(out)>::value_type;
+        size_t n = 0;
+        const T* data = compiledLevel.section<T>(s, n);
+        out.assign(data, data + n);
+    };
+    const int32_t* routeTiles = compiledLevel.section<int32_t>(LEVEL_ROUTE_TILES, count);
+    copy(route.clusters, LEVEL_ROUTE_CLUSTERS);
+    copy(route.members, LEVEL_ROUTE_MEMBERS);
+    copy(route.nodes, LEVEL_ROUTE_NODES);
+    copy(route.edges, LEVEL_ROUTE_EDGES);
+    copy(route.doors, LEVEL_ROUTE_DOORS);
+    if (routeTiles && count == tileCount && routeGraph.load(w, h, routeTiles, route)) {
+        enemies.routeGraph = &routeGraph;
+        std::cout << "Route graph: " << routeGraph.clusterCount() << " clusters, "
+                  << routeGraph.portalCount() << " portals (precomputed)\n";
+    }
+    else
+        buildRouteGraph();
+
+    size_t linkCount = 0;
+    const int32_t* areaTiles = compiledLevel.section<int32_t>(LEVEL_AREA_TILES, count);
+    const AreaGraph::SavedLink* links =
+        compiledLevel.section<AreaGraph::SavedLink>(LEVEL_AREA_LINKS, linkCount);
+    if (areaTiles && count == tileCount &&
+        areas.load(w, h, areaTiles, compiledLevel.areaCount(), links, linkCount))
+        initAreaState();
+    else
+        buildAreaGraph();
+    finishLevelLoad();
+}
+
+// Level compiler: everything the loaders produced, written as arrays
+bool Game::compileLevel(const std::string& path)
+{
+    if (Map.empty()) {
+        std::cerr << "No level loaded to compile\n";
+        return false;
+    }
+    int w = Map.width(), h = Map.height();
+    std::vector<LevelDoor> levelDoors;
+    for (size_t k = 0; k < doors.size(); k++)
+        levelDoors.push_back({doors.owner(k), (uint8_t)doors[k].locked,
+                              (uint8_t)doors[k].keyType, 0});
+
+    std::string names;
+    for (const auto& type : enemies.archetypes)
+        names += type.name + '\0';
+    std::vector<LevelEnemy> spawns;
+    for (int i = 0; i < (int)enemyLoadLocations.size(); i++)
+        spawns.push_back({enemyLoadLocations[i].first, enemyLoadLocations[i].second,
+                          (int32_t)enemies.archetype[i]});
+
+    std::vector<AreaGraph::SavedLink> links;
+    areas.save(links);
+    PathGraph::Saved route;
+    routeGraph.save(route);
+
+    size_t tileCount = static_cast<size_t>(w) * h;
+    LevelFile::Writer out(w, h, areas.areaCount());
+    out.add(LEVEL_TILES, Map.data(), tileCount);
+    out.add(LEVEL_DOORS, levelDoors.data(), levelDoors.size());
+    out.add(LEVEL_OBJECTS, mapObjects.data(), mapObjects.size());
+    out.add(LEVEL_ENEMIES, spawns.data(), spawns.size());
+    out.add(LEVEL_ENEMY_TYPES, names.data(), names.size());
+    out.add(LEVEL_COLLISION, collision.words().data(), collision.words().size());
+    out.add(LEVEL_AREA_TILES, areas.areaTiles(), tileCount);
+    out.add(LEVEL_AREA_LINKS, links.data(), links.size());
+    out.add(LEVEL_ROUTE_TILES, routeGraph.clusterTiles(), tileCount);
+    out.add(LEVEL_ROUTE_CLUSTERS, route.clusters.data(), route.clusters.size());
+    out.add(LEVEL_ROUTE_MEMBERS, route.members.data(), route.members.size());
+    out.add(LEVEL_ROUTE_NODES, route.nodes.data(), route.nodes.size());
+    out.add(LEVEL_ROUTE_EDGES, route.edges.data(), route.edges.size());
+    out.add(LEVEL_ROUTE_DOORS, route.doors.data(), route.doors.size());
+    if (!out.write(path))
+        return false;
+    std::cout << "Compiled " << w << "x" << h << " level with " << doors.size()
+              << " doors, " << mapObjects.size() << " objects, " << spawns.size()
+              << " enemies: " << path << "\n";
+    return true;
 }
 
 
@@ -250,29 +396,59 @@ void Game::loadAllTextures(std::string f)
     }
 }
 
-void Game::loadExitFrame(const char* filePath){
-    int i = exitTexture.size() % 2;
-    SDL_Texture* raw = IMG_LoadTexture(renderer.get(), filePath);
-    if (!raw) {
-        std::cerr << "Failed to load Switch texture: "
+// A texture and its size, handed to done() once loading gets to it.
+// Headless there is no renderer, so the image is decoded only for its
+// size and the handle is left empty. On failure done() is not called.
+void Game::loadTexture(const std::string& filePath, const char* what, TextureFn done)
+{
+    auto failed = [filePath, what]() {
+        std::cerr << "Failed to load " << what << " texture: "
                   << filePath << " | " << IMG_GetError() << "\n";
+    };
+    if (headless) {
+        AssetLoader::image(filePath, [done, failed](SDL_Surface* surface) {
+            if (!surface) return failed();
+            done(SDLTexturePtr(), surface->w, surface->h);
+        });
         return;
     }
-    int height = 0, width = 0;
-    if (SDL_QueryTexture(raw, nullptr, nullptr, &width, &height) != 0) {
-        std::cerr << "Failed to query texture: "
-                  << SDL_GetError() << "\n";
-        SDL_DestroyTexture(raw);
-        return;
-    }
-    exitWH[static_cast<SwitchState>(i)] = std::make_pair(width, height);
-    exitTexture.emplace(static_cast<SwitchState>(i), SDLTexturePtr(raw,
-    SDL_DestroyTexture));
-    std::cout << "exit "<<i+1<<"\n";
+    AssetLoader::texture(renderer.get(), filePath, "world", [done, failed](SDLTexturePtr texture) {
+        int width = 0, height = 0;
+        if (!texture) return failed();
+        if (SDL_QueryTexture(texture.get(), nullptr, nullptr, &width, &height) != 0)
+            return failed();
+        done(texture, width, height);
+    });
+}
+
+void Game::loadExitFrame(const char* filePath){
+    loadTexture(filePath, "Switch", [this](SDLTexturePtr texture, int width, int height) {
+        int i = exitTexture.size() % 2;
+        exitWH[static_cast<SwitchState>(i)] = std::make_pair(width, height);
+        exitTexture.emplace(static_cast<SwitchState>(i), texture);
+        std::cout << "exit "<<i+1<<"\n";
+    });
 }
 
-void Game::loadEnemyTextures(std::string f)
+void Game::loadEnemyArchetypes(std::string f)
 {
+    enemies.loadArchetypes(f);
+    enemyVisuals.clear();
+    enemyVisuals.resize(enemies.archetypes.size());
+}
+
+void Game::loadEnemyArchetypeTextures(std::string base)
+{
+    for (size_t t = 0; t < enemies.archetypes.size(); t++)
+        loadEnemyTextures(base + "/" + enemies.archetypes[t].framesFile, (int)t);
+}
+
+void Game::loadEnemyTextures(std::string f, int archetypeId)
+{
+    if (archetypeId < 0) return;
+    if (archetypeId >= (int)enemyVisuals.size())
+        enemyVisuals.resize(archetypeId + 1);
+
     const char* filePath = f.c_str();
     std::ifstream file(filePath);
     if (!file.is_open()) {
@@ -300,15 +476,30 @@ void Game::loadEnemyTextures(std::string f)
 
         // Expect: <int> <int> <string>
         if (iss >> a >> b >> path) {
-            SDL_Texture* texture = IMG_LoadTexture(renderer.get(), path.c_str());
-            if (!texture) {
-                std::cerr << "Failed to load texture: " << filePath << " Error: " << IMG_GetError() << std::endl;
-                return;
-            }
-            enemyTextures.insert_or_assign(
-                {a, b},
-                SDLTexturePtr(texture, SDL_DestroyTexture)
-            );
+            // The surface feeds the hit mask; the texture request for the
+            // same path shares its decode
+            AssetLoader::image(path, [this, archetypeId, a, b, path](SDL_Surface* surface) {
+                EnemyVisuals& visuals = enemyVisuals[archetypeId];
+                if (!surface) {
+                    std::cerr << "Failed to load texture: " << path << " Error: " << IMG_GetError() << std::endl;
+                    return;
+                }
+                visuals.hitMasks.insert_or_assign({a, b}, HitMask::fromSurface(surface));
+                visuals.width = surface->w;
+                visuals.height = surface->h;
+                // Keep the frame key so animation lookups still succeed
+                // headless, where there is no texture
+                if (headless)
+                    visuals.textures.insert_or_assign({a, b}, SDLTexturePtr());
+            });
+            if (headless) continue;
+            AssetLoader::texture(renderer.get(), path, "enemy", [this, archetypeId, a, b, path](SDLTexturePtr texture) {
+                if (!texture) {
+                    std::cerr << "Failed to load texture: " << path << " Error: " << SDL_GetError() << std::endl;
+                    return;
+                }
+                enemyVisuals[archetypeId].textures.insert_or_assign({a, b}, texture);
+            });
         }
     }
 }
@@ -333,14 +524,25 @@ void Game::loadEnemies(std::string f)
         if (line.empty() || line[0] == '#')
             continue;
 
+        // Format: <x> <y> [type]
         std::istringstream iss(line);
         if (!(iss >> x >> y))
         {
             std::cerr << "Invalid enemy entry: " << line << '\n';
             continue;
         }
+        int type = 0;
+        std::string typeName;
+        if (iss >> typeName) {
+            type = enemies.findArchetype(typeName);
+            if (type < 0) {
+                std::cerr << "Unknown enemy type '" << typeName
+                          << "', using " << enemies.archetypes[0].name << '\n';
+                type = 0;
+            }
+        }
         enemyLoadLocations.push_back(std::make_pair(x, y));
-        addEnemy(x, y, 0.0f);
+        addEnemy(x, y, 0.0f, type);
     }
 
     file.close();
@@ -348,81 +550,37 @@ void Game::loadEnemies(std::string f)
 
 void Game::loadKeysTexture(const char* filePath)
 {
-    SDL_Texture* raw = IMG_LoadTexture(renderer.get(), filePath);
-    if (!raw) {
-        std::cerr << "Failed to load key texture: "
-                  << filePath << " | " << IMG_GetError() << "\n";
-        return;
-    }
-    int keyType = keysTextures.size() + 1;
-    int height = 0, width = 0;
-    if (SDL_QueryTexture(raw, nullptr, nullptr, &width, &height) != 0) {
-        std::cerr << "Failed to query texture: "
-                  << SDL_GetError() << "\n";
-        SDL_DestroyTexture(raw);
-        return;
-    }
-    keysTextures.emplace_back(raw, SDL_DestroyTexture);
-    keyWidthsHeights[keyType] = std::make_pair(width, height);
+    loadTexture(filePath, "key", [this](SDLTexturePtr texture, int width, int height) {
+        int keyType = keysTextures.size() + 1;
+        keysTextures.push_back(texture);
+        keyWidthsHeights[keyType] = std::make_pair(width, height);
+    });
 }
 
 
 void Game::loadWeaponsTexture(const char* filePath)
 {
-    SDL_Texture* raw = IMG_LoadTexture(renderer.get(), filePath);
-    if (!raw) {
-        std::cerr << "Failed to load weapon texture: "
-                  << filePath << " | " << IMG_GetError() << "\n";
-        return;
-    }
-    int height = 0, width = 0;
-    if (SDL_QueryTexture(raw, nullptr, nullptr, &width, &height) != 0) {
-        std::cerr << "Failed to query texture: "
-                  << SDL_GetError() << "\n";
-        SDL_DestroyTexture(raw);
-        return;
-    }
-    int weaponsType = weaponsTextures.size() + 1;
-    weaponWidthsHeights[weaponsType] = std::make_pair(width, height);
-    weaponsTextures.emplace_back(raw, SDL_DestroyTexture);
+    loadTexture(filePath, "weapon", [this](SDLTexturePtr texture, int width, int height) {
+        int weaponsType = weaponsTextures.size() + 1;
+        weaponWidthsHeights[weaponsType] = std::make_pair(width, height);
+        weaponsTextures.push_back(texture);
+    });
 }   
 
 void Game::loadHealthPackTexture(const char* filePath)
 {
-    SDL_Texture* raw = IMG_LoadTexture(renderer.get(), filePath);
-    if (!raw) {
-        std::cerr << "Failed to load health pack texture: "
-                  << filePath << " | " << IMG_GetError() << "\n";
-        return;
-    }
-    int height = 0, width = 0;
-    if (SDL_QueryTexture(raw, nullptr, nullptr, &width, &height) != 0) {
-        std::cerr << "Failed to query texture: "
-                  << SDL_GetError() << "\n";
-        SDL_DestroyTexture(raw);
-        return;
-    }
-    int healthPackType = healthPackTextures.size() + 1;
-    healthPackWidthsHeights[healthPackType] = std::make_pair(width, height);
-    healthPackTextures.emplace_back(raw, SDL_DestroyTexture);
+    loadTexture(filePath, "health pack", [this](SDLTexturePtr texture, int width, int height) {
+        int healthPackType = healthPackTextures.size() + 1;
+        healthPackWidthsHeights[healthPackType] = std::make_pair(width, height);
+        healthPackTextures.push_back(texture);
+    });
 }
 void Game::loadAmmoPackTexture(const char* filePath){
-    SDL_Texture* raw = IMG_LoadTexture(renderer.get(), filePath);
-    if (!raw) {
-        std::cerr << "Failed to load health pack texture: "
-                  << filePath << " | " << IMG_GetError() << "\n";
-        return;
-    }
-    int height = 0, width = 0;
-    if (SDL_QueryTexture(raw, nullptr, nullptr, &width, &height) != 0) {
-        std::cerr << "Failed to query texture: "
-                  << SDL_GetError() << "\n";
-        SDL_DestroyTexture(raw);
-        return;
-    }
-    int ammoPackType = ammoPackTextures.size() + 1;
-    ammoPackWidthsHeights[ammoPackType] = std::make_pair(width, height);
-    ammoPackTextures.emplace_back(raw, SDL_DestroyTexture);
+    loadTexture(filePath, "ammo pack", [this](SDLTexturePtr texture, int width, int height) {
+        int ammoPackType = ammoPackTextures.size() + 1;
+        ammoPackWidthsHeights[ammoPackType] = std::make_pair(width, height);
+        ammoPackTextures.push_back(texture);
+    });
 }
 
 void Game::loadDecorationTextures(std::string f)
@@ -494,28 +652,14 @@ void Game::loadDecorationTextures(std::string f)
         addDecorationTexture(key, texturePath.c_str());
     }
 
-    std::cout << "Decoration textures loaded successfully\n";
+    std::cout << "Decoration textures queued\n";
 }
 void Game::loadDoorFrame(const char* filePath)
 {
-    SDL_Texture* raw = IMG_LoadTexture(renderer.get(), filePath);
-    if (!raw) {
-        std::cerr << "Failed to load Door frame texture: "
-                  << filePath << " | " << IMG_GetError() << "\n";
-        return;
-    }
-
-    int width = 0, height = 0;
-    if (SDL_QueryTexture(raw, nullptr, nullptr, &width, &height) != 0) {
-        std::cerr << "Failed to query texture: "
-                  << SDL_GetError() << "\n";
-        SDL_DestroyTexture(raw);
-        return;
-    }
-
-    // Wrap with shared_ptr + SDL_DestroyTexture deleter
-    DOOR_FRAME = SDLTexturePtr(raw, SDL_DestroyTexture);
+    loadTexture(filePath, "Door frame", [this](SDLTexturePtr texture, int width, int height) {
+        DOOR_FRAME = texture;
 
-    // store dimensions
-    doorFrameWidthHeight  = std::make_pair(width, height);
+        // store dimensions
+        doorFrameWidthHeight  = std::make_pair(width, height);
+    });
 }
\ No newline at end of file
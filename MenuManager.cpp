@@ -1,4 +1,5 @@
 #include "MenuManager.hpp"
+#include "AssetLoader.hpp"
 #include <sstream>
 std::unordered_map<
     Menu,
@@ -57,6 +58,10 @@ std::unordered_map<
 SDLTexturePtr MenuManager::cursorImage{nullptr, SDL_DestroyTexture};
 std::pair<int, int> MenuManager::cursorImageWH;
 std::string MenuManager::displayTxt;
+bool MenuManager::dirty = true;
+bool MenuManager::presentPending = true;
+SDLTexturePtr MenuManager::menuFrame{nullptr, SDL_DestroyTexture};
+std::pair<int, int> MenuManager::menuFrameWH{0, 0};
 
 // Actions
 void play(GameState& state){
@@ -166,14 +171,34 @@ std::unordered_map<Menu, std::string, MenuHash> MenuManager::titles ={
 
 void MenuManager::set_displayTxt(std::string x){
     displayTxt = x;
+    dirty = true;
 }
 bool MenuManager::handleEvents(GameState& state){
     SDL_Event event;
 
-    while (SDL_PollEvent(&event))
+    // Sleep until something happens, then drain the queue. A menu that
+    // still has to be shown (setMenu without input) must not wait.
+    if (dirty || presentPending) {
+        if (!SDL_PollEvent(&event))
+            return false;
+    }
+    else if (!SDL_WaitEventTimeout(&event, idleWaitMs))
+        return false;
+
+    do
     {
         if (event.type == SDL_QUIT)
             return true;
+        if (event.type == SDL_WINDOWEVENT)
+            presentPending = true; // exposed/resized: re-show cached frame
+        if (event.type == SDL_RENDER_TARGETS_RESET ||
+            event.type == SDL_RENDER_DEVICE_RESET) {
+            UIManager::clearTextCache(); // baked runs lost their pixels
+            // So did the menu frame; after a device reset it is gone
+            if (event.type == SDL_RENDER_DEVICE_RESET)
+                menuFrame.reset();
+            dirty = true;
+        }
         if (event.type == SDL_KEYDOWN && event.key.repeat == 0)
         {
             if (event.key.keysym.scancode == SDL_SCANCODE_UP)
@@ -195,31 +220,97 @@ bool MenuManager::handleEvents(GameState& state){
                 select(state);
             }
         }
-    }
+    } while (SDL_PollEvent(&event));
     return false;
 }
 
 void MenuManager::loadCursorImage(const char* filePath, SDL_Renderer& renderer)
 {
-    SDL_Texture* raw = IMG_LoadTexture(&renderer, filePath);
-    if (!raw) {
-        std::cerr << "Failed to load Cursor texture: "
-                  << filePath << " | " << IMG_GetError() << "\n";
+    std::string path = filePath;
+    AssetLoader::texture(&renderer, path, "menu", [path](SDLTexturePtr texture) {
+        if (!texture) {
+            std::cerr << "Failed to load Cursor texture: "
+                      << path << " | " << IMG_GetError() << "\n";
+            return;
+        }
+
+        cursorImage = texture;
+
+        int width = 0, height = 0;
+        if (SDL_QueryTexture(texture.get(), nullptr, nullptr, &width, &height) != 0) {
+            std::cerr << "Failed to query texture: "
+                      << SDL_GetError() << "\n";
+            return;
+        }
+        cursorImageWH = std::make_pair(width, height);
+    });
+}
+
+void MenuManager::renderMenu(SDL_Renderer& renderer, const std::pair<int, int>& screenWH){
+    if (!dirty && !presentPending)
+        return;
+
+    if (!SDL_RenderTargetSupported(&renderer)) {
+        drawMenu(renderer, screenWH);
+        SDL_RenderPresent(&renderer);
+        dirty = presentPending = false;
         return;
     }
 
-    cursorImage = SDLTexturePtr(raw, SDL_DestroyTexture);
+    if (!menuFrame || menuFrameWH != screenWH) {
+        SDL_Texture* raw = SDL_CreateTexture(&renderer, SDL_PIXELFORMAT_RGBA8888,
+            SDL_TEXTUREACCESS_TARGET, screenWH.first, screenWH.second);
+        if (!raw) {
+            std::cerr << "Failed to create menu frame: "
+                      << SDL_GetError() << "\n";
+            return;
+        }
+        menuFrame = SDLTexturePtr(raw, SDL_DestroyTexture);
+        menuFrameWH = screenWH;
+        dirty = true;
+    }
 
-    int width = 0, height = 0;
-    if (SDL_QueryTexture(raw, nullptr, nullptr, &width, &height) != 0) {
-        std::cerr << "Failed to query texture: "
-                  << SDL_GetError() << "\n";
-        return;
+    if (dirty) {
+        SDL_SetRenderTarget(&renderer, menuFrame.get());
+        drawMenu(renderer, screenWH);
+        SDL_SetRenderTarget(&renderer, nullptr);
+        dirty = false;
     }
-    cursorImageWH = std::make_pair(width, height);
+
+    SDL_RenderCopy(&renderer, menuFrame.get(), nullptr, nullptr);
+    SDL_RenderPresent(&renderer);
+    presentPending = false;
 }
 
-void MenuManager::renderMenu(SDL_Renderer& renderer, const std::pair<int, int>& screenWH){
+// Drawn straight to the screen every frame while assets load; the font
+// is not in yet, so it is only a bar
+void MenuManager::renderLoading(SDL_Renderer& renderer, const std::pair<int, int>& screenWH, float progress){
+    auto background = std::get<0>(menuColors);
+    auto foreground = std::get<1>(menuColors);
+    auto barColor = std::get<2>(menuColors);
+
+    UIManager::drawFilledRectWithBorder(renderer,
+        {0,0,screenWH.first, screenWH.second},
+        background, background, 0
+    );
+    int w = screenWH.first / 2, h = 24, border = 3;
+    int x = screenWH.first/2 - w/2;
+    int y = screenWH.second/2 - h/2;
+    UIManager::drawFilledRectWithBorder(renderer,
+        {x,y,w,h},
+        background, foreground, border
+    );
+    int filled = static_cast<int>((w - 2 * border) * std::clamp(progress, 0.0f, 1.0f));
+    if (filled > 0)
+        UIManager::drawFilledRectWithBorder(renderer,
+            {x + border, y + border, filled, h - 2 * border},
+            barColor, barColor, 0
+        );
+    SDL_RenderPresent(&renderer);
+    dirty = true; // the menu frame is no longer on screen
+}
+
+void MenuManager::drawMenu(SDL_Renderer& renderer, const std::pair<int, int>& screenWH){
     auto background = std::get<0>(menuColors);
     auto foreground = std::get<1>(menuColors);
     auto fontclrHig = std::get<2>(menuColors);
@@ -314,8 +405,5 @@ void MenuManager::renderMenu(SDL_Renderer& renderer, const std::pair<int, int>&
         y = UIManager::getGlyphSize().second * 2;
         UIManager::renderText(renderer, titles[currentMenu], x, y, scale, fontclrHig);
     }
-
-    SDL_RenderPresent(&renderer);
-
 }
 
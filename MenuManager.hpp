@@ -31,6 +31,7 @@ public:
         // WHICH MENU TO SHOW?
         currentMenu = menu;
         optionSelected = 0;
+        dirty = true;
     }
 
     static void bind(Menu menu, int option, Action action) {
@@ -41,6 +42,7 @@ public:
     static void moveUp() {
         if (optionSelected > 0){
             optionSelected--;
+            dirty = true;
         }
     }
 
@@ -48,6 +50,7 @@ public:
         int max = optionCounts[currentMenu];
         if (optionSelected + 1 < max) {
             optionSelected++;
+            dirty = true;
         }
         std::cout<<optionSelected<<std::endl;
     }
@@ -67,10 +70,18 @@ public:
     static void Init(SDL_Renderer&);
     static bool handleEvents(GameState&);
     static void renderMenu(SDL_Renderer&, const std::pair<int, int>&); // use UIManager here
+    static void renderLoading(SDL_Renderer&, const std::pair<int, int>&, float progress);
     // No "update" needed in menus, also no separate textures
     // only plain filled squares and text
     // (not implementing any animations)
+    // Menus are static, so they are drawn once into menuFrame and
+    // only redrawn when dirty (input, selection or setMenu change)
+    static constexpr int idleWaitMs = 500;
 private:
+    static void drawMenu(SDL_Renderer&, const std::pair<int, int>&);
+    static bool dirty, presentPending;
+    static SDLTexturePtr menuFrame;
+    static std::pair<int, int> menuFrameWH;
     static Menu currentMenu;
     static int optionSelected;
     static SDLTexturePtr cursorImage;
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+
+// Asset pack (.pak) layout, shared by the game and tools/assetpack.
+// A header, then the entry table sorted by name (bytewise), then the
+// names, then the files. Every part starts on a packAlign boundary.
+// Written in the packing host's byte order.
+
+static const char packMagic[4] = {'W', '3', 'D', 'P'};
+static const uint16_t packVersion = 1;
+static const uint16_t packByteOrder = 0x0102;
+static const uint64_t packAlign = 16;
+
+struct PackHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t byteOrder;
+    uint32_t count;         // entries
+    uint32_t pad;
+    uint64_t namesOffset;
+    uint64_t namesSize;
+};
+
+struct PackEntry {
+    uint64_t offset;        // file bytes, from the start of the pack
+    uint64_t size;
+    uint32_t nameOffset;    // into the names block, not NUL terminated
+    uint32_t nameLength;
+};
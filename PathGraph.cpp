@@ -0,0 +1,353 @@
+#include "PathGraph.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <queue>
+
+static const int dirs[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+static_assert(sizeof(int) == sizeof(int32_t), "saved tiles are read as int");
+
+void PathGraph::clear() {
+    width = height = 0;
+    cluster.clear();
+    clusterOf = nullptr;
+    clusters.clear();
+    nodes.clear();
+    nodeOfTile.clear();
+    doorTiles.clear();
+    doorOfTile.clear();
+}
+
+int PathGraph::nodeAt(int x, int y) {
+    int tile = y * width + x;
+    auto it = nodeOfTile.find(tile);
+    if (it != nodeOfTile.end())
+        return it->second;
+    int id = static_cast<int>(nodes.size());
+    nodes.push_back({x, y, cluster[tile], {}});
+    clusters[cluster[tile]].nodes.push_back(id);
+    nodeOfTile[tile] = id;
+    return id;
+}
+
+void PathGraph::link(int a, int b, int cost, int door) {
+    for (const Edge& e : nodes[a].edges)
+        if (e.to == b) return;
+    nodes[a].edges.push_back({b, cost, door});
+    nodes[b].edges.push_back({a, cost, door});
+}
+
+void PathGraph::build(int w, int h, const TileFn& isFloor,
+    const TileFn& isDoor, const TileFn& isBlocked)
+{
+    clear();
+    width = w;
+    height = h;
+    cluster.assign(static_cast<size_t>(w) * h, -1);
+    clusterOf = cluster.data();
+
+    // Clusters: floor flood fill that stays inside one sector
+    std::vector<int> stack;
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            if (cluster[y * w + x] >= 0 || !isFloor(x, y)) continue;
+            int id = static_cast<int>(clusters.size());
+            int sx = x / sectorSize, sy = y / sectorSize;
+            clusters.push_back({sx * sectorSize, sy * sectorSize, {}});
+            cluster[y * w + x] = id;
+            stack.push_back(y * w + x);
+            while (!stack.empty()) {
+                int t = stack.back();
+                stack.pop_back();
+                int tx = t % w, ty = t / w;
+                for (const auto& d : dirs) {
+                    int nx = tx + d[0], ny = ty + d[1];
+                    if (nx < 0 || ny < 0 || nx >= w || ny >= h) continue;
+                    if (nx / sectorSize != sx || ny / sectorSize != sy) continue;
+                    int n = ny * w + nx;
+                    if (cluster[n] >= 0 || !isFloor(nx, ny)) continue;
+                    cluster[n] = id;
+                    stack.push_back(n);
+                }
+            }
+        }
+    }
+
+    // Door portals: floor on opposite sides of a door tile
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            if (!isDoor(x, y)) continue;
+            for (int axis = 0; axis < 2; axis++) {
+                int ax = x - (axis == 0), ay = y - (axis == 1);
+                int bx = x + (axis == 0), by = y + (axis == 1);
+                if (clusterAt(ax, ay) < 0 || clusterAt(bx, by) < 0) continue;
+                int door = static_cast<int>(doorTiles.size());
+                doorTiles.push_back({x, y, isBlocked(x, y)});
+                doorOfTile.emplace(y * w + x, door); // keeps the first
+                link(nodeAt(ax, ay), nodeAt(bx, by), 2, door);
+            }
+        }
+    }
+
+    // Sector entrances: one portal pair per run of open border tiles
+    auto scanBorder = [&](bool vertical) {
+        int lines = vertical ? w : h, span = vertical ? h : w;
+        for (int b = sectorSize; b < lines; b += sectorSize) {
+            int runStart = -1, runA = -1, runB = -1;
+            for (int s = 0; s <= span; s++) {
+                int ax = vertical ? b - 1 : s, ay = vertical ? s : b - 1;
+                int bx = vertical ? b : s,     by = vertical ? s : b;
+                int ca = s < span ? clusterAt(ax, ay) : -1;
+                int cb = s < span ? clusterAt(bx, by) : -1;
+                bool open = ca >= 0 && cb >= 0;
+                if (runStart >= 0 && (!open || ca != runA || cb != runB)) {
+                    int mid = (runStart + s - 1) / 2;
+                    if (vertical) link(nodeAt(b - 1, mid), nodeAt(b, mid), 1, -1);
+                    else          link(nodeAt(mid, b - 1), nodeAt(mid, b), 1, -1);
+                    runStart = -1;
+                }
+                if (open && runStart < 0) {
+                    runStart = s;
+                    runA = ca;
+                    runB = cb;
+                }
+            }
+        }
+    };
+    scanBorder(true);
+    scanBorder(false);
+
+    // Intra-cluster edges between every pair of portals
+    std::vector<int> dist;
+    for (int c = 0; c < (int)clusters.size(); c++) {
+        const auto& members = clusters[c].nodes;
+        for (size_t a = 0; a < members.size(); a++) {
+            const Node& na = nodes[members[a]];
+            clusterDistances(c, na.x, na.y, dist);
+            for (size_t b = a + 1; b < members.size(); b++) {
+                const Node& nb = nodes[members[b]];
+                int d = dist[localIndex(c, nb.x, nb.y)];
+                if (d >= 0)
+                    link(members[a], members[b], d, -1);
+            }
+        }
+    }
+}
+
+void PathGraph::save(Saved& out) const {
+    out = Saved();
+    for (const Cluster& c : clusters) {
+        out.clusters.push_back({c.x0, c.y0, (int32_t)out.members.size(),
+                                (int32_t)c.nodes.size()});
+        out.members.insert(out.members.end(), c.nodes.begin(), c.nodes.end());
+    }
+    for (const Node& n : nodes) {
+        out.nodes.push_back({n.x, n.y, n.cluster, (int32_t)out.edges.size(),
+                             (int32_t)n.edges.size()});
+        for (const Edge& e : n.edges)
+            out.edges.push_back({e.to, e.cost, e.door});
+    }
+    for (const DoorPortal& d : doorTiles)
+        out.doors.push_back({d.x, d.y, d.blocked});
+}
+
+bool PathGraph::load(int w, int h, const int32_t* tiles, const Saved& in) {
+    clear();
+    auto inRange = [](int32_t first, int32_t count, size_t size) {
+        return first >= 0 && count >= 0 && (size_t)first + count <= size;
+    };
+    // Tiles of a cluster must lie in its sector, as localIndex assumes
+    auto inSector = [&](const SavedCluster& c, int x, int y) {
+        return x >= c.x0 && x < c.x0 + sectorSize && y >= c.y0 && y < c.y0 + sectorSize &&
+               x >= 0 && y >= 0 && x < w && y < h;
+    };
+    for (const SavedCluster& c : in.clusters) {
+        if (!inRange(c.firstMember, c.memberCount, in.members.size())) return false;
+        if (c.x0 < 0 || c.y0 < 0 || c.x0 % sectorSize || c.y0 % sectorSize) return false;
+    }
+    for (const SavedNode& n : in.nodes)
+        if (!inRange(n.firstEdge, n.edgeCount, in.edges.size()) ||
+            n.cluster < 0 || (size_t)n.cluster >= in.clusters.size() ||
+            !inSector(in.clusters[n.cluster], n.x, n.y)) return false;
+    for (const SavedCluster& c : in.clusters)
+        for (int32_t k = c.firstMember; k < c.firstMember + c.memberCount; k++) {
+            int32_t m = in.members[k];
+            if (m < 0 || (size_t)m >= in.nodes.size() ||
+                !inSector(c, in.nodes[m].x, in.nodes[m].y)) return false;
+        }
+    for (int32_t m : in.members)
+        if (m < 0 || (size_t)m >= in.nodes.size()) return false;
+    for (const SavedEdge& e : in.edges)
+        if (e.to < 0 || (size_t)e.to >= in.nodes.size() ||
+            e.door < -1 || e.door >= (int32_t)in.doors.size()) return false;
+    for (const SavedDoor& d : in.doors)
+        if (d.x < 0 || d.y < 0 || d.x >= w || d.y >= h) return false;
+    for (int y = 0; y < h; y++)
+        for (int x = 0; x < w; x++) {
+            int32_t c = tiles[static_cast<size_t>(y) * w + x];
+            if (c < -1 || c >= (int32_t)in.clusters.size() ||
+                (c >= 0 && !inSector(in.clusters[c], x, y))) return false;
+        }
+
+    width = w;
+    height = h;
+    clusterOf = tiles;
+    for (const SavedCluster& c : in.clusters)
+        clusters.push_back({c.x0, c.y0, std::vector<int>(in.members.begin() + c.firstMember,
+                            in.members.begin() + c.firstMember + c.memberCount)});
+    for (const SavedNode& n : in.nodes) {
+        Node node{n.x, n.y, n.cluster, {}};
+        for (int32_t e = n.firstEdge; e < n.firstEdge + n.edgeCount; e++)
+            node.edges.push_back({in.edges[e].to, in.edges[e].cost, in.edges[e].door});
+        nodes.push_back(std::move(node));
+    }
+    for (size_t d = 0; d < in.doors.size(); d++) {
+        const SavedDoor& door = in.doors[d];
+        doorTiles.push_back({door.x, door.y, door.blocked != 0});
+        doorOfTile.emplace(door.y * w + door.x, (int)d); // keeps the first
+    }
+    return true;
+}
+
+void PathGraph::setDoorBlocked(int x, int y, bool blocked) {
+    if (x < 0 || y < 0 || x >= width || y >= height) return;
+    auto it = doorOfTile.find(y * width + x);
+    if (it == doorOfTile.end()) return;
+    // A door tile may carry two portals (both axes), stored together
+    for (size_t d = it->second; d < doorTiles.size() &&
+         doorTiles[d].x == x && doorTiles[d].y == y; d++)
+        doorTiles[d].blocked = blocked;
+}
+
+void PathGraph::clusterDistances(int c, int x, int y, std::vector<int>& dist) const {
+    dist.assign(sectorSize * sectorSize, -1);
+    std::vector<int> queue;
+    queue.reserve(sectorSize * sectorSize);
+    dist[localIndex(c, x, y)] = 0;
+    queue.push_back(y * width + x);
+    for (size_t head = 0; head < queue.size(); head++) {
+        int t = queue[head];
+        int tx = t % width, ty = t / width;
+        int d = dist[localIndex(c, tx, ty)];
+        for (const auto& dir : dirs) {
+            int nx = tx + dir[0], ny = ty + dir[1];
+            if (clusterAt(nx, ny) != c) continue;
+            int& nd = dist[localIndex(c, nx, ny)];
+            if (nd >= 0) continue;
+            nd = d + 1;
+            queue.push_back(ny * width + nx);
+        }
+    }
+}
+
+bool PathGraph::plan(int sx, int sy, int gx, int gy, PathRoute& route) const {
+    route.clear();
+    route.goalX = gx;
+    route.goalY = gy;
+    int cs = clusterAt(sx, sy), cg = clusterAt(gx, gy);
+    if (cs < 0 || cg < 0) return false;
+    if (cs == cg) {
+        route.waypoints.push_back({gx, gy});
+        return true;
+    }
+
+    // Start and goal join the graph through their own cluster's portals
+    std::vector<int> startDist, goalDist;
+    clusterDistances(cs, sx, sy, startDist);
+    clusterDistances(cg, gx, gy, goalDist);
+    std::unordered_map<int, int> goalCost; // portal -> cost to goal
+    for (int n : clusters[cg].nodes) {
+        int d = goalDist[localIndex(cg, nodes[n].x, nodes[n].y)];
+        if (d >= 0) goalCost[n] = d;
+    }
+    if (goalCost.empty()) return false;
+
+    // A* over portals, sparse bookkeeping so a query never touches
+    // the whole graph
+    auto heuristic = [&](int n) {
+        return std::abs(nodes[n].x - gx) + std::abs(nodes[n].y - gy);
+    };
+    using Entry = std::pair<int, int>; // (f, node)
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    std::unordered_map<int, int> g, parent;
+    for (int n : clusters[cs].nodes) {
+        int d = startDist[localIndex(cs, nodes[n].x, nodes[n].y)];
+        if (d < 0) continue;
+        g[n] = d;
+        parent[n] = -1;
+        open.push({d + heuristic(n), n});
+    }
+
+    int best = -1, bestCost = 0;
+    while (!open.empty()) {
+        auto [f, n] = open.top();
+        open.pop();
+        int gn = g[n];
+        if (f != gn + heuristic(n)) continue; // stale
+        if (best >= 0 && f >= bestCost) break;
+
+        auto goal = goalCost.find(n);
+        if (goal != goalCost.end() && (best < 0 || gn + goal->second < bestCost)) {
+            best = n;
+            bestCost = gn + goal->second;
+        }
+        for (const Edge& e : nodes[n].edges) {
+            if (e.door >= 0 && doorTiles[e.door].blocked) continue;
+            int ng = gn + e.cost;
+            auto it = g.find(e.to);
+            if (it != g.end() && it->second <= ng) continue;
+            g[e.to] = ng;
+            parent[e.to] = n;
+            open.push({ng + heuristic(e.to), e.to});
+        }
+    }
+    if (best < 0) return false;
+
+    for (int n = best; n >= 0; n = parent[n])
+        route.waypoints.push_back({nodes[n].x, nodes[n].y});
+    std::reverse(route.waypoints.begin(), route.waypoints.end());
+    route.waypoints.push_back({gx, gy});
+    return true;
+}
+
+bool PathGraph::nextStep(int x, int y, PathRoute& route, int& nx, int& ny) const {
+    while (!route.done() && route.waypoints[route.next] == std::make_pair(x, y))
+        route.next++;
+    if (route.done()) return false;
+
+    auto [wx, wy] = route.waypoints[route.next];
+    int c = clusterAt(x, y);
+    if (c >= 0 && c == clusterAt(wx, wy)) {
+        // Refine this leg inside the cluster: walk downhill from the waypoint
+        std::vector<int> dist;
+        clusterDistances(c, wx, wy, dist);
+        int best = dist[localIndex(c, x, y)];
+        if (best < 0) return false;
+        bool found = false;
+        for (const auto& d : dirs) {
+            int tx = x + d[0], ty = y + d[1];
+            if (clusterAt(tx, ty) != c) continue;
+            int td = dist[localIndex(c, tx, ty)];
+            if (td >= 0 && td < best) {
+                best = td;
+                nx = tx;
+                ny = ty;
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    // Portal crossing: next to it, or one door tile in between
+    int dx = wx - x, dy = wy - y;
+    if (std::abs(dx) + std::abs(dy) == 1) {
+        nx = wx;
+        ny = wy;
+        return true;
+    }
+    if ((std::abs(dx) == 2 && dy == 0) || (dx == 0 && std::abs(dy) == 2)) {
+        nx = x + dx / 2;
+        ny = y + dy / 2;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Waypoints from PathGraph::plan, consumed one tile step at a time
+struct PathRoute {
+    std::vector<std::pair<int, int>> waypoints;
+    size_t next = 0;
+    int goalX = -1, goalY = -1;
+
+    bool done() const { return next >= waypoints.size(); }
+    void clear() { waypoints.clear(); next = 0; goalX = goalY = -1; }
+};
+
+// HPA*-style abstraction of the tile grid, built once at load. Floor
+// is cut into clusters: connected rooms and corridors, split at door
+// tiles and at sectorSize x sectorSize sector borders. Portals sit on
+// both sides of every door and sector crossing. A query plans over the
+// portal graph and each leg is refined inside one cluster only, so
+// cost follows the number of rooms crossed and not the map area.
+class PathGraph {
+public:
+    using TileFn = std::function<bool(int, int)>;
+
+    // isFloor: walkable, isDoor: door tile joining two clusters,
+    // isBlocked: door currently impassable (locked)
+    void build(int width, int height, const TileFn& isFloor,
+               const TileFn& isDoor, const TileFn& isBlocked);
+    void clear();
+
+    // Re-weight the portal through a door tile (locked / unlocked)
+    void setDoorBlocked(int x, int y, bool blocked);
+
+    // Abstract route from (sx, sy) to (gx, gy); false if unreachable
+    bool plan(int sx, int sy, int gx, int gy, PathRoute& route) const;
+    // Next tile to walk to along route from (x, y); false -> replan
+    bool nextStep(int x, int y, PathRoute& route, int& nx, int& ny) const;
+
+    int clusterAt(int x, int y) const {
+        if (x < 0 || y < 0 || x >= width || y >= height) return -1;
+        return clusterOf[y * width + x];
+    }
+    int clusterCount() const { return static_cast<int>(clusters.size()); }
+    int portalCount() const { return static_cast<int>(nodes.size()); }
+
+    static const int sectorSize = 32;
+
+    // Saved form, for compiled levels: flat arrays in build order (edges
+    // and cluster members grouped per node / cluster). load() borrows
+    // tiles, which must outlive the graph; false if the arrays disagree.
+    struct SavedCluster { int32_t x0, y0, firstMember, memberCount; };
+    struct SavedNode { int32_t x, y, cluster, firstEdge, edgeCount; };
+    struct SavedEdge { int32_t to, cost, door; };
+    struct SavedDoor { int32_t x, y, blocked; };
+    struct Saved {
+        std::vector<SavedCluster> clusters;
+        std::vector<int32_t> members;
+        std::vector<SavedNode> nodes;
+        std::vector<SavedEdge> edges;
+        std::vector<SavedDoor> doors;
+    };
+    const int* clusterTiles() const { return clusterOf; }
+    void save(Saved& out) const;
+    bool load(int width, int height, const int32_t* tiles, const Saved& in);
+
+private:
+    struct Edge {
+        int to;
+        int cost;
+        int door = -1;       // index into doorTiles for door crossings
+    };
+    struct Node {
+        int x, y, cluster;
+        std::vector<Edge> edges;
+    };
+    struct Cluster {
+        int x0, y0;          // sector origin, for local indexing
+        std::vector<int> nodes;
+    };
+    struct DoorPortal {
+        int x, y;
+        bool blocked;
+    };
+
+    int nodeAt(int x, int y);
+    void link(int a, int b, int cost, int door);
+    // BFS inside one cluster from (x, y); dist is sectorSize^2, -1 = unseen
+    void clusterDistances(int c, int x, int y, std::vector<int>& dist) const;
+    int localIndex(int c, int x, int y) const {
+        return (y - clusters[c].y0) * sectorSize + (x - clusters[c].x0);
+    }
+
+    int width = 0, height = 0;
+    std::vector<int> cluster;        // tile -> cluster id, -1 if none
+    const int* clusterOf = nullptr;  // cluster's data, or a loaded view
+    std::vector<Cluster> clusters;
+    std::vector<Node> nodes;
+    std::unordered_map<int, int> nodeOfTile;
+    std::vector<DoorPortal> doorTiles;
+    std::unordered_map<int, int> doorOfTile;
+};
@@ -0,0 +1,142 @@
+#include "Game.hpp"
+#include "UIManager.hpp"
+#include "AudioManager.hpp"
+
+// A pickup standing on floor tile (x, y)
+void Game::addItem(PickupKind kind, int type, int x, int y,
+                   const SDLTexturePtr& texture, const std::pair<int, int>& wh)
+{
+    Entity e = createEntity(x + 0.5f, y + 0.5f, Sprite{texture, wh.first, wh.second});
+    pickups.add(e, Pickup{kind, type});
+    indexPickup(e);
+}
+
+void Game::indexPickup(Entity e)
+{
+    const Position& p = positions.get(e);
+    itemIndex.insert(e, p.x, p.y);
+}
+
+// Only pickups within the largest collection radius are tried, so the
+// cost does not depend on how many items the level has. Id order keeps
+// several pickups in reach on one tick deterministic.
+void Game::collectPickups()
+{
+    float reach = std::max({keyRadius, weaponRadius, healthPackRadius, ammoPackRadius});
+    itemIndex.queryRadius(playerPosition.first, playerPosition.second, reach, nearbyItems);
+    std::sort(nearbyItems.begin(), nearbyItems.end());
+    for (Entity e : nearbyItems) {
+        if (!tryCollect(pickups.get(e), positions.get(e)))
+            continue;
+        // Remove from map
+        hideSprite(e);
+        itemIndex.remove(e);
+    }
+}
+
+// In radius of the item, and only when the player can use it
+bool Game::tryCollect(const Pickup& p, const Position& at)
+{
+    float radius = p.kind == PickupKind::KEY    ? keyRadius
+                 : p.kind == PickupKind::WEAPON ? weaponRadius
+                 : p.kind == PickupKind::HEALTH ? healthPackRadius
+                                                : ammoPackRadius;
+    float dx = at.x - playerPosition.first;
+    float dy = at.y - playerPosition.second;
+    if (dx * dx + dy * dy >= radius * radius)
+        return false;
+
+    switch (p.kind) {
+        case PickupKind::KEY:
+            if (playerHasKey(p.type))
+                return false;
+            acquireKey(p.type);
+            UIManager::addKey(static_cast<KeyType>(p.type - 1));
+            return true;
+
+        case PickupKind::WEAPON:
+            if (playerHasWeapon(p.type))
+                return false;
+            acquireWeapon(p.type);
+            return true;
+
+        case PickupKind::HEALTH:
+            if (health >= 100)
+                return false;
+            health += healAmounts[p.type];
+            if (health > 100) health = 100;
+            if (!headless) std::cout << "Health : " << health << "\n";
+            AudioManager::playSFX("pickup", MIX_MAX_VOLUME / 2);
+            return true;
+
+        case PickupKind::AMMO: {
+            int weaponType = 2 + ((p.type + 1) % 2);
+            if (!playerHasWeapon(weaponType))
+                return false; // Player doesn't have the weapon
+            weapon& w = weapons[weaponType];
+            if (w.ammo >= w.maxAmmo) {
+                w.ammo = w.maxAmmo;
+                return false;
+            }
+            w.ammo += ammoAmounts[p.type];
+            if (w.ammo >= w.maxAmmo)
+                w.ammo = w.maxAmmo;
+            if (!headless)
+                std::cout << "Ammo of weapon num " << weaponType << " = " << w.ammo << "\n";
+            AudioManager::playSFX("pickup", MIX_MAX_VOLUME / 2);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Drop spawned ammo (entities past loadedEntityCount) and put every
+// loaded item back
+void Game::resetPickups()
+{
+    for (Entity e = loadedEntityCount; e < nextEntity; e++) {
+        pickups.remove(e);
+        positions.remove(e);
+        sprites.remove(e);
+        hiddenSprites.remove(e);
+    }
+    nextEntity = loadedEntityCount;
+    while (!hiddenSprites.empty())
+        showSprite(hiddenSprites.owner(hiddenSprites.size() - 1));
+    reindexPickups();
+}
+
+Entity Game::createEntity(float x, float y, Sprite sprite)
+{
+    Entity e = nextEntity++;
+    positions.add(e, Position{x, y});
+    sprites.add(e, std::move(sprite));
+    return e;
+}
+
+// Both stores are packed, so Render walks only what is drawn, and a
+// sprite goes in and out in O(1)
+void Game::showSprite(Entity e)
+{
+    Sprite* sprite = hiddenSprites.find(e);
+    if (!sprite)
+        return;
+    sprites.add(e, std::move(*sprite));
+    hiddenSprites.remove(e);
+}
+
+void Game::hideSprite(Entity e)
+{
+    Sprite* sprite = sprites.find(e);
+    if (!sprite)
+        return;
+    hiddenSprites.add(e, std::move(*sprite));
+    sprites.remove(e);
+}
+
+void Game::reindexPickups()
+{
+    itemIndex.clear();
+    for (size_t k = 0; k < pickups.size(); k++)
+        indexPickup(pickups.owner(k));
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdint>
+
+// Tiny deterministic PRNG (splitmix64). Each enemy owns one, so rolls
+// do not depend on the order enemies are processed in.
+struct Random {
+    uint64_t state;
+
+    explicit Random(uint64_t seed = 0) : state(seed) {}
+
+    uint32_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return static_cast<uint32_t>((z ^ (z >> 31)) >> 32);
+    }
+    // [0, n); 0 when n <= 0
+    int range(int n) { return n > 0 ? static_cast<int>(next() % n) : 0; }
+    // [0, 1]
+    float unit() { return next() / 4294967295.0f; }
+};
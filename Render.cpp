@@ -91,9 +91,8 @@ void Game::render()
                     continue;
                 }
                 float open = 0.0f;
-                auto it = doors.find({mapX, mapY});
-                if (it != doors.end()) {
-                    open = it->second.openAmount;
+                if (const Door* d = doorAt(mapX, mapY)) {
+                    open = d->openAmount;
                 } else {
                     std::cout << "Door at "<<mapY<<", "<<mapX<<" not found\n";
                     return;
@@ -216,9 +215,9 @@ void Game::render()
                 
             }
         }
-        else if (wallX > doors[{mapX, mapY}].openAmount)
+        else if (wallX > doorAt(mapX, mapY)->openAmount)
         {
-            wallX -= doors[{mapX, mapY}].openAmount;
+            wallX -= doorAt(mapX, mapY)->openAmount;
 
             int texX = int(wallX * imgWidth);
             texX = std::clamp(texX, 0, imgWidth - 1);
@@ -236,26 +235,30 @@ void Game::render()
     }
     // Rendering Sprites
     // Sort sprites by distance from player (far to near)
-    std::sort(renderOrder.begin(), renderOrder.end(),
+    // Sprites in rooms cut off from the player can't be seen: skip
+    // drawOrder holds slots in the packed sprite store
+    auto positionOf = [&](int k) -> const Position& {
+        return positions.get(sprites.owner(k));
+    };
+    drawOrder.clear();
+    for (int k = 0; k < (int)sprites.size(); k++)
+        if (inActiveArea(positionOf(k).x, positionOf(k).y))
+            drawOrder.push_back(k);
+    std::sort(drawOrder.begin(), drawOrder.end(),
         [&](int a, int b) {
-            return distSq(playerPosition, AllSpriteTextures[a].position) >
-           distSq(playerPosition, AllSpriteTextures[b].position);
+            const Position& pa = positionOf(a);
+            const Position& pb = positionOf(b);
+            return distSq(playerPosition, {pa.x, pa.y}) >
+           distSq(playerPosition, {pb.x, pb.y});
         });
-    int enemyShotIndex = -1;
-    for (int i=0; i < renderOrder.size(); i++) {
-        int id = renderOrder[i];
-        const Sprite& sprite = AllSpriteTextures[id];
+    for (int i=0; i < drawOrder.size(); i++) {
+        int k = drawOrder[i];
+        const Sprite& sprite = sprites[k];
         if (!sprite.texture){
-            //std::cout << "Skipping sprite ID " << sprite.spriteID << " due to null texture.\n";
-            //std::cout << sprite.isEnemy << "\n";
             continue; // skip if texture is null
         }
         // Sprite position relative to player
-        auto [sx, sy] = sprite.position;
-        if(!sprite.isEnemy){
-            sx += 0.5f;
-            sy += 0.5f;
-        }
+        float sx = positionOf(k).x, sy = positionOf(k).y;
         float dx = sx - playerPosition.first;
         float dy = sy - playerPosition.second;
         float spriteDist = sqrt(dx*dx + dy*dy);
@@ -283,40 +286,6 @@ void Game::render()
         int drawStartX = screenX - spriteWidth / 2;
         int drawEndX   = screenX + spriteWidth / 2;
 
-        int centreX = ScreenHeightWidth.first / 2;
-
-        if(sprite.isEnemy && shotThisFrame && spriteDist < weapons[currentWeapon].range
-            && drawStartX + spriteWidth * (1-enemyBoundBox)/2 < centreX
-            && drawEndX - spriteWidth * (1-enemyBoundBox)/2 > centreX
-            && zBuffer[centreX] > spriteDist
-        ){
-            enemyShotIndex = enemySpriteIDToindex.at(sprite.spriteID);
-            std::cout << drawStartX << ", " << drawEndX << " " << centreX << "\n";
-        }
-        else if(shotThisFrame && sprite.isEnemy && 
-            ( drawStartX + spriteWidth * (1-enemyBoundBox) > centreX
-            || drawEndX - spriteWidth * (1-enemyBoundBox) < centreX)
-        ){
-            std::cout << "Enemy at sprite ID " << sprite.spriteID << " not at centre\n";
-        }
-        else if(sprite.isEnemy && shotThisFrame){ 
-            std::cout << "Enemy at sprite ID " << sprite.spriteID << " out of range for shooting,\n dist=" << spriteDist << " and range=" << weapons[currentWeapon].range << "\n";
-        }
-
-        if(sprite.isEnemy){
-            /*
-            SDL_RenderDrawLine(renderer.get(),
-                (int)(drawStartX + spriteWidth * (1-enemyBoundBox)/2), 0,
-                (int)(drawStartX + spriteWidth * (1-enemyBoundBox)/2), ScreenHeightWidth.second
-            );
-
-            SDL_RenderDrawLine(renderer.get(),
-                (int)(drawEndX - spriteWidth * (1-enemyBoundBox)/2), 0,
-                (int)(drawEndX - spriteWidth * (1-enemyBoundBox)/2), ScreenHeightWidth.second
-            );
-            */
-        }
-
         SDL_Texture* texture = sprite.texture.get();
 
         // Render sprite column by column
@@ -331,32 +300,6 @@ void Game::render()
             }
         }
     }
-    if (enemyShotIndex != -1) {
-        auto [x, y] = enemies[enemyShotIndex]->get_position();
-        float dist = distSq(
-            playerPosition,
-            enemies[enemyShotIndex]->get_position()
-        );
-        dist = sqrt(dist); // sqrt
-        int dmg=0;
-        if(canShootEnemy(dist))
-            dmg = (rand() & 31) * weapons[currentWeapon].multiplier;
-        std::cout << "Enemy at index " << enemyShotIndex << " shot for " << dmg << " damage.\n";
-        if(enemies[enemyShotIndex]->takeDamage(dmg)){    
-            spawnRandomAmmoPack(std::make_pair((int)x, (int)y)); 
-        }
-        shotThisFrame = false;
-    }
-    else if (shotThisFrame) {
-        shotThisFrame = false;
-    }
-        /*
-        SDL_RenderDrawLine(renderer.get(),
-            ScreenHeightWidth.first/2, 0,
-            ScreenHeightWidth.first/2, ScreenHeightWidth.second
-            );
-        */
-
     UIManager::renderHUD(
         getRenderer(),
         ScreenHeightWidth
@@ -8,27 +8,24 @@ void Game::restart(){
     currentWeapon=0;
     keysHeld.clear();
     musicTrack = 1;
-    for (int i=0; i<enemies.size(); i++){
-        enemies[i]->setPosition(enemyLoadLocations[i]);
-        enemies[i]->reset();
-    }
-    for (auto& [pos, d] : doors){
-        d.openAmount = 0.0f;
-        d.vacant = true;
-        d.opening = false;
-        d.closing = false;
-        d.openTimer = 0.0f;
+    timers.clear(); // pending cooldowns and door closes belong to the old run
+    hasShot = false;
+    pendingInput = TickInput();
+    // A demo covers one run: the menu choice to restart is not recorded
+    if (demo.recording()) {
+        std::cout << "Demo recorded: " << demo.ticks << " ticks\n";
+        demo.stop();
     }
-    std::sort(indexOfSpawnedAmmos.begin(), 
-    indexOfSpawnedAmmos.end(), std::greater<int>());
-    for (int idx : indexOfSpawnedAmmos) {
-        if (idx >= 0 && idx < static_cast<int>(AllSpriteTextures.size())) {
-            AllSpriteTextures.erase(AllSpriteTextures.begin() + idx);
-        }
-    }
-    for (int i=0; i<AllSpriteTextures.size(); i++){
-        AllSpriteTextures[i].active = true;
+    for (int i=0; i<enemies.size(); i++){
+        enemies.reset(i, enemyLoadLocations[i].first, enemyLoadLocations[i].second);
+        enemyIndex.update(i, enemyLoadLocations[i].first, enemyLoadLocations[i].second);
+        positions.get(enemies.get_entity(i)) =
+            Position{enemyLoadLocations[i].first, enemyLoadLocations[i].second};
+        placeEnemyInArea(i);
     }
+    resetDoors();
+    resetPickups();
+    seedRandom(rngSeed);
     UIManager::reset();
     state = GameState::GAMEPLAY;
 }
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include "SpatialHash.hpp"
+#include <algorithm>
+#include <cmath>
+
+int SpatialHash::cellCoord(float v) const {
+    return static_cast<int>(std::floor(v / cellSize));
+}
+
+void SpatialHash::clear() {
+    cells.clear();
+    cellOf.clear();
+    present.clear();
+    where.clear();
+}
+
+void SpatialHash::insert(int id, float x, float y) {
+    if (id < 0) return;
+    if (id >= static_cast<int>(present.size())) {
+        present.resize(id + 1, 0);
+        cellOf.resize(id + 1, 0);
+        where.resize(id + 1);
+    }
+    if (present[id]) {
+        update(id, x, y);
+        return;
+    }
+    CellKey key = keyOf(cellCoord(x), cellCoord(y));
+    where[id] = {x, y};
+    cells[key].push_back(id);
+    cellOf[id] = key;
+    present[id] = 1;
+}
+
+void SpatialHash::update(int id, float x, float y) {
+    if (!contains(id)) {
+        insert(id, x, y);
+        return;
+    }
+    CellKey key = keyOf(cellCoord(x), cellCoord(y));
+    where[id] = {x, y};
+    if (key == cellOf[id])
+        return; // still in the same cell, nothing else to do
+    remove(id);
+    insert(id, x, y);
+}
+
+void SpatialHash::remove(int id) {
+    if (!contains(id)) return;
+    auto it = cells.find(cellOf[id]);
+    if (it != cells.end()) {
+        auto& bucket = it->second;
+        auto pos = std::find(bucket.begin(), bucket.end(), id);
+        if (pos != bucket.end()) {
+            *pos = bucket.back();
+            bucket.pop_back();
+        }
+        if (bucket.empty())
+            cells.erase(it);
+    }
+    present[id] = 0;
+}
+
+bool SpatialHash::contains(int id) const {
+    return id >= 0 && id < static_cast<int>(present.size()) && present[id];
+}
+
+void SpatialHash::appendCell(int cx, int cy, std::vector<int>& out) const {
+    auto it = cells.find(keyOf(cx, cy));
+    if (it != cells.end())
+        out.insert(out.end(), it->second.begin(), it->second.end());
+}
+
+void SpatialHash::queryAABB(float minX, float minY, float maxX, float maxY,
+    std::vector<int>& out) const
+{
+    out.clear();
+    if (cells.empty()) return;
+    int x0 = cellCoord(minX), x1 = cellCoord(maxX);
+    int y0 = cellCoord(minY), y1 = cellCoord(maxY);
+    for (int cy = y0; cy <= y1; cy++)
+        for (int cx = x0; cx <= x1; cx++)
+            appendCell(cx, cy, out);
+}
+
+void SpatialHash::queryRadius(float x, float y, float r, std::vector<int>& out) const {
+    queryAABB(x - r, y - r, x + r, y + r, out);
+    out.erase(std::remove_if(out.begin(), out.end(), [&](int id) {
+        float dx = where[id].first - x, dy = where[id].second - y;
+        return dx*dx + dy*dy > r*r;
+    }), out.end());
+}
+
+void SpatialHash::queryRay(
+    float ox, float oy, float dx, float dy,
+    float maxDist, float padding,
+    std::vector<int>& out) const
+{
+    out.clear();
+    if (cells.empty()) return;
+
+    int pad = static_cast<int>(std::ceil(padding / cellSize));
+
+    // DDA over cells, same stepping as the wall raycaster
+    float x = ox / cellSize, y = oy / cellSize;
+    int cx = cellCoord(ox), cy = cellCoord(oy);
+    int stepX = (dx < 0) ? -1 : 1;
+    int stepY = (dy < 0) ? -1 : 1;
+    float deltaDistX = (dx == 0) ? 1e30f : std::fabs(1.0f / dx);
+    float deltaDistY = (dy == 0) ? 1e30f : std::fabs(1.0f / dy);
+    float sideDistX = (dx < 0) ? (x - cx) * deltaDistX : (cx + 1.0f - x) * deltaDistX;
+    float sideDistY = (dy < 0) ? (y - cy) * deltaDistY : (cy + 1.0f - y) * deltaDistY;
+    float maxCells = maxDist / cellSize;
+
+    float travelled = 0.0f;
+    while (travelled <= maxCells) {
+        for (int oyc = -pad; oyc <= pad; oyc++)
+            for (int oxc = -pad; oxc <= pad; oxc++)
+                appendCell(cx + oxc, cy + oyc, out);
+
+        if (sideDistX < sideDistY) {
+            travelled = sideDistX;
+            sideDistX += deltaDistX;
+            cx += stepX;
+        } else {
+            travelled = sideDistY;
+            sideDistY += deltaDistY;
+            cy += stepY;
+        }
+    }
+
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
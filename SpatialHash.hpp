@@ -0,0 +1,47 @@
+#pragma once
+#include <unordered_map>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+// Uniform grid of buckets keyed by cell, holding small integer ids
+// (enemy indices, item entities). Only occupied cells are stored, so memory follows
+// the number of entities and not the map size.
+class SpatialHash {
+public:
+    explicit SpatialHash(float cellSize = 1.0f) : cellSize(cellSize) {}
+
+    void clear();
+    void insert(int id, float x, float y);
+    void update(int id, float x, float y);
+    void remove(int id);
+    bool contains(int id) const;
+    std::pair<float, float> positionOf(int id) const { return where[id]; }
+
+    // Ids in cells overlapping [minX, maxX] x [minY, maxY]; callers do
+    // their own exact test. Unsorted.
+    void queryAABB(float minX, float minY, float maxX, float maxY,
+                   std::vector<int>& out) const;
+    // Ids whose stored position is within r of (x, y). Unsorted.
+    void queryRadius(float x, float y, float r, std::vector<int>& out) const;
+
+    // Ids in every cell a ray passes through, plus cells within
+    // `padding` of it (entities are not points). Sorted, unique.
+    void queryRay(float ox, float oy, float dx, float dy,
+                  float maxDist, float padding,
+                  std::vector<int>& out) const;
+
+private:
+    using CellKey = std::int64_t;
+    CellKey keyOf(int cx, int cy) const {
+        return (static_cast<CellKey>(cy) << 32) ^ static_cast<std::uint32_t>(cx);
+    }
+    int cellCoord(float v) const;
+    void appendCell(int cx, int cy, std::vector<int>& out) const;
+
+    float cellSize;
+    std::unordered_map<CellKey, std::vector<int>> cells;
+    std::vector<CellKey> cellOf;     // id -> cell it is stored in
+    std::vector<char> present;       // id -> stored?
+    std::vector<std::pair<float, float>> where; // id -> last position
+};
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// The level's tile grid: one byte per tile, row-major, every row the
+// same width. Text maps own their tiles; a compiled level's grid is
+// viewed in place inside the mapped file. Read as Map[y][x].
+class TileMap {
+public:
+    struct Row {
+        const uint8_t* tiles;
+        int count;
+        int operator[](int x) const { return tiles[x]; }
+        size_t size() const { return static_cast<size_t>(count); }
+    };
+
+    Row operator[](int y) const { return {tiles + static_cast<size_t>(y) * w, w}; }
+    size_t size() const { return static_cast<size_t>(h); }
+    bool empty() const { return h == 0; }
+    int width() const { return w; }
+    int height() const { return h; }
+    const uint8_t* data() const { return tiles; }
+
+    // Takes ownership of width * height tiles
+    void assign(int width, int height, std::vector<uint8_t> grid) {
+        owned = std::move(grid);
+        w = width;
+        h = height;
+        tiles = owned.data();
+    }
+    // Borrows: grid must outlive the map (or the next assign/view/clear)
+    void view(int width, int height, const uint8_t* grid) {
+        owned.clear();
+        w = width;
+        h = height;
+        tiles = grid;
+    }
+    void clear() {
+        owned.clear();
+        w = h = 0;
+        tiles = nullptr;
+    }
+
+private:
+    std::vector<uint8_t> owned;
+    const uint8_t* tiles = nullptr;
+    int w = 0, h = 0;
+};
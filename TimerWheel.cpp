@@ -0,0 +1,116 @@
+#include "TimerWheel.hpp"
+
+static const uint64_t wheelSpan = 1ull << (TimerWheel::levels * TimerWheel::slotBits);
+
+// Ids pack the pool index with a generation, so a stale id never
+// cancels whoever reused the slot
+static TimerWheel::TimerId makeId(int index, uint32_t generation) {
+    return (static_cast<uint64_t>(generation) << 32) | static_cast<uint32_t>(index + 1);
+}
+
+TimerWheel::TimerId TimerWheel::schedule(uint32_t delay, Callback fn) {
+    int t;
+    if (freeList >= 0) {
+        t = freeList;
+        freeList = pool[t].next;
+    } else {
+        t = static_cast<int>(pool.size());
+        pool.emplace_back();
+    }
+    Timer& timer = pool[t];
+    timer.due = current + (delay > 0 ? delay : 1);
+    timer.fn = std::move(fn);
+    timer.live = true;
+    place(t);
+    return makeId(t, timer.generation);
+}
+
+void TimerWheel::cancel(TimerId id) {
+    if (!pending(id)) return;
+    // Left in its slot and skipped when the slot is reached
+    Timer& timer = pool[static_cast<uint32_t>(id) - 1];
+    timer.live = false;
+    timer.fn = nullptr;
+}
+
+bool TimerWheel::pending(TimerId id) const {
+    uint32_t index = static_cast<uint32_t>(id);
+    if (index == 0 || index > pool.size()) return false;
+    const Timer& timer = pool[index - 1];
+    return timer.live && timer.generation == static_cast<uint32_t>(id >> 32);
+}
+
+void TimerWheel::place(int t) {
+    Timer& timer = pool[t];
+    uint64_t delta = timer.due > current ? timer.due - current : 0;
+    // Too far out: park at the horizon, the cascade re-places it later
+    uint64_t at = delta < wheelSpan ? timer.due : current + wheelSpan - 1;
+    int level = 0;
+    while (level < levels - 1 && delta >= (1ull << ((level + 1) * slotBits)))
+        level++;
+    int& head = slot(level, (at >> (level * slotBits)) & (slots - 1));
+    timer.next = head;
+    head = t;
+}
+
+// Move every timer of the current slot at `level` one level down
+void TimerWheel::cascade(int level) {
+    int& head = slot(level, (current >> (level * slotBits)) & (slots - 1));
+    int t = head;
+    head = -1;
+    while (t >= 0) {
+        int next = pool[t].next;
+        if (pool[t].live) place(t);
+        else release(t);
+        t = next;
+    }
+}
+
+void TimerWheel::release(int t) {
+    Timer& timer = pool[t];
+    timer.fn = nullptr;
+    timer.live = false;
+    timer.generation++;
+    timer.next = freeList;
+    freeList = t;
+}
+
+void TimerWheel::tick() {
+    current++;
+    // Each coarser level turns over when the finer one wraps to 0
+    for (int level = 1; level < levels; level++) {
+        if ((current >> ((level - 1) * slotBits)) & (slots - 1)) break;
+        cascade(level);
+    }
+
+    // Detach first: callbacks may schedule, but never into this slot.
+    // A callback that clears has released the rest of the list too, so
+    // the walk ends there.
+    int& head = slot(0, current & (slots - 1));
+    int t = head;
+    head = -1;
+    while (t >= 0) {
+        int next = pool[t].next;
+        if (pool[t].live) {
+            Callback fn = std::move(pool[t].fn);
+            release(t);
+            uint64_t clearsBefore = clears;
+            fn();
+            if (clears != clearsBefore)
+                return;
+        } else {
+            release(t);
+        }
+        t = next;
+    }
+}
+
+void TimerWheel::clear() {
+    clears++;
+    for (int& head : heads)
+        head = -1;
+    // Keep the pool so generations survive and old ids stay stale
+    freeList = -1;
+    for (int t = static_cast<int>(pool.size()) - 1; t >= 0; t--)
+        release(t);
+}
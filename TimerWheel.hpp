@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Hierarchical timing wheel driven by the fixed simulation tick. Four
+// levels of 64 slots cover 2^24 ticks (~77 h at 60 Hz); a timer sits in
+// the coarsest slot that still separates it from now and cascades down
+// as its time approaches. Scheduling, cancelling and an idle tick are
+// O(1), so anything waiting on a timer costs nothing until it fires.
+class TimerWheel {
+public:
+    using Callback = std::function<void()>;
+    using TimerId = uint64_t;   // 0 = no timer
+
+    // Run fn after `delay` ticks (at least 1)
+    TimerId schedule(uint32_t delay, Callback fn);
+    // Safe on ids that already fired or were cancelled
+    void cancel(TimerId id);
+    bool pending(TimerId id) const;
+
+    // Step one tick and fire what is due; callbacks may (re)schedule,
+    // cancel or clear
+    void tick();
+    uint64_t now() const { return current; }
+    // Drop every timer (restart, map load); the clock keeps running
+    void clear();
+
+    static const int levels = 4;
+    static const int slotBits = 6;
+    static const int slots = 1 << slotBits;
+
+private:
+    struct Timer {
+        uint64_t due = 0;
+        Callback fn;
+        uint32_t generation = 0;
+        int next = -1;          // next timer in the same slot, or free list
+        bool live = false;
+    };
+
+    void place(int t);
+    void cascade(int level);
+    void release(int t);
+    int& slot(int level, int index) { return heads[level * slots + index]; }
+
+    uint64_t current = 0;
+    uint64_t clears = 0;        // bumped by clear(), so tick() can stop
+    std::vector<Timer> pool;
+    int freeList = -1;
+    std::vector<int> heads = std::vector<int>(levels * slots, -1);
+};
@@ -1,4 +1,5 @@
 #include "UIManager.hpp"
+#include "AssetLoader.hpp"
 #include <fstream>
 // ---- Static member definitions ----
 
@@ -20,12 +21,16 @@ std::map<WeaponType, UIAnimation> UIManager::weaponAnimations = {
     { WeaponType::Rifle,  UIAnimation{} }
 };
 std::vector<UIAnimation> UIManager::AvatarAnimation{};
-float UIManager::avatarTimer = 0.0f;
 float UIManager::avatarFrameDuration = 1.0f;
 int UIManager::avatarFrame = 0;
+Random UIManager::rng;
 int UIManager::curr_avatar_state = 0;
 std::pair<int, int> UIManager::AvatarDimensions = {0, 0};
 BitmapFont UIManager::font;
+std::list<TextRun> UIManager::textRuns{};
+std::unordered_map<TextRunKey, std::list<TextRun>::iterator, TextRunHash>
+    UIManager::textRunIndex{};
+std::size_t UIManager::textRunBytes = 0;
 SDL_Rect UIManager::panel = { 0, 0, 0, 0 };
 
 int UIManager::panelHeight = 100;
@@ -47,7 +52,9 @@ std::map<KeyType, SDLTexturePtr> UIManager::keyUITextures={};
 std::map<KeyType, std::pair<int, int>> UIManager::keyUITexturesWH={};
 
 std::vector<Notif> UIManager::UINotification = {};
-float UIManager::notifUpdateTimer = 0.0f;
+TimerWheel* UIManager::timers = nullptr;
+TimerWheel::TimerId UIManager::notifTimer = 0;
+TimerWheel::TimerId UIManager::avatarTimer = 0;
 
 static const char* weaponTypeToString(WeaponType w)
 {
@@ -71,6 +78,8 @@ void UIManager::loadTextures(std::string f, SDL_Renderer& rend){
     enum Section { NONE, KNIFE, PISTOL, RIFLE, FONT, WEAPONPANEL, KEYS, AVATAR};
     Section currentSection = NONE;
     int AvatarAnimState = 0;
+    // Counted here: the panel maps only fill in once loading finishes
+    int weaponPanels = 0, keyPanels = 0;
     std::string line;
     while (std::getline(file, line)) {
 
@@ -129,11 +138,11 @@ void UIManager::loadTextures(std::string f, SDL_Renderer& rend){
             loadFont(line.c_str(), rend);
         }
         else if (currentSection == WEAPONPANEL){
-            addPanelTextureW(static_cast<WeaponType>(panelWeaponImage.size()+1)
+            addPanelTextureW(static_cast<WeaponType>(++weaponPanels)
             , line.c_str(), rend);
         }
         else if (currentSection == KEYS){
-            addPanelTextureK(static_cast<KeyType>(keyUITextures.size())
+            addPanelTextureK(static_cast<KeyType>(keyPanels++)
             , line.c_str(), rend);
         }
         else if (currentSection == AVATAR){
@@ -147,57 +156,57 @@ void UIManager::loadTextures(std::string f, SDL_Renderer& rend){
             std::cerr << "Warning: Path found outside any valid section: " << line << "\n";
         }
     }
-    std::cout<<"ALL HUD TEXTURES LOADED\n";
+    std::cout<<"ALL HUD TEXTURES QUEUED\n";
 }
 
 void UIManager::addTexture(WeaponType weapon, const char* filePath, SDL_Renderer& renderer){
-    SDL_Texture* raw = IMG_LoadTexture(&renderer, filePath);
-    if (!raw) {
-        std::cerr << "Failed to load Weapon HUD texture: "
-                  << filePath << " | " << IMG_GetError() << "\n";
-        return;
-    }
+    std::string path = filePath;
+    AssetLoader::texture(&renderer, path, "HUD", [weapon, path](SDLTexturePtr texture) {
+        if (!texture) {
+            std::cerr << "Failed to load Weapon HUD texture: "
+                      << path << " | " << IMG_GetError() << "\n";
+            return;
+        }
 
-    weaponAnimations[weapon].frames.emplace_back(raw, SDL_DestroyTexture);
+        weaponAnimations[weapon].frames.push_back(texture);
+    });
 }
 
 void UIManager::addAvatarFrame(const char* filePath, SDL_Renderer& renderer, int state){
-    SDL_Texture* raw = IMG_LoadTexture(&renderer, filePath);
-    if (!raw) {
-        std::cerr << "Failed to Avatar texture: "
-                  << filePath << " | " << IMG_GetError() << "\n";
-        return;
-    }
-    if (AvatarDimensions.first == 0 && AvatarDimensions.second == 0){
-        int width = 0, height = 0;
-        if (SDL_QueryTexture(raw, nullptr, nullptr, &width, &height) != 0) {
-            std::cerr << "Failed to query texture: "
-                      << SDL_GetError() << "\n";
+    std::string path = filePath;
+    AssetLoader::texture(&renderer, path, "HUD", [state, path](SDLTexturePtr texture) {
+        if (!texture) {
+            std::cerr << "Failed to Avatar texture: "
+                      << path << " | " << IMG_GetError() << "\n";
             return;
         }
-        AvatarDimensions = std::make_pair(width, height);
-    }
-    if(AvatarAnimation.size()<state)
-	    AvatarAnimation.push_back(UIAnimation());
-    AvatarAnimation[state-1].frames.emplace_back(raw, SDL_DestroyTexture);
+        if (AvatarDimensions.first == 0 && AvatarDimensions.second == 0){
+            int width = 0, height = 0;
+            if (SDL_QueryTexture(texture.get(), nullptr, nullptr, &width, &height) != 0) {
+                std::cerr << "Failed to query texture: "
+                          << SDL_GetError() << "\n";
+                return;
+            }
+            AvatarDimensions = std::make_pair(width, height);
+        }
+        if(AvatarAnimation.size()<state)
+            AvatarAnimation.push_back(UIAnimation());
+        AvatarAnimation[state-1].frames.push_back(texture);
+    });
 }
 
 void UIManager::update(float deltaTime)
 {
-    if(UINotification.size())
-        notifUpdateTimer += deltaTime;
-    if(notifUpdateTimer > notifDuration){
-        updateNotifications();
-        notifUpdateTimer = 0.0f;
-    }
-
-    avatarTimer += deltaTime;
+    // One wake-up per notification shown and per avatar frame; nothing
+    // counts in between
+    if (timers && !UINotification.empty() && !timers->pending(notifTimer))
+        notifTimer = timers->schedule(Game::ticksFor(notifDuration),
+            []{ updateNotifications(); });
+    // No frames when the HUD was never loaded (headless)
+    if (timers && !AvatarAnimation.empty() && !timers->pending(avatarTimer))
+        avatarTimer = timers->schedule(Game::ticksFor(avatarFrameDuration),
+            []{ nextAvatarFrame(); });
     curr_avatar_state= (100-health) * AvatarAnimation.size() / 101 ;
-    while (avatarTimer >= avatarFrameDuration)
-    {
-        avatarTimer -= avatarFrameDuration;
-        avatarFrame = rand() % AvatarAnimation[curr_avatar_state].frames.size();
-    }
 
     if (!animating) return;
 
@@ -221,6 +230,11 @@ void UIManager::update(float deltaTime)
     }
 }
 
+void UIManager::nextAvatarFrame(){
+    curr_avatar_state= (100-health) * AvatarAnimation.size() / 101 ;
+    avatarFrame = rng.range(AvatarAnimation[curr_avatar_state].frames.size());
+}
+
 void UIManager::updateNotifications(){
     if(UINotification.size()){
         UINotification.erase(UINotification.begin());
@@ -428,13 +442,36 @@ void UIManager::renderText(
     int scale,
     SDL_Color color
 ) {
-    // Apply color modulation ONCE
+    if (text.empty() || !font.texture) return;
+
+    // Baked run -> one draw call, scale is applied by the destination rect
+    const TextRun* run = getTextRun(renderer, text, color);
+    if (run) {
+        SDL_Rect dst { x, y, run->width * scale, run->height * scale };
+        SDL_RenderCopy(&renderer, run->texture.get(), nullptr, &dst);
+        return;
+    }
+
+    // Fallback (no render targets / oversized run): glyph by glyph
     SDL_SetTextureColorMod(
         font.texture.get(),
         color.r, color.g, color.b
     );
     SDL_SetTextureAlphaMod(font.texture.get(), color.a);
 
+    renderGlyphs(renderer, text, x, y, scale);
+
+    // Reset modulation to avoid affecting other draws
+    SDL_SetTextureColorMod(font.texture.get(), 255, 255, 255);
+    SDL_SetTextureAlphaMod(font.texture.get(), 255);
+}
+
+void UIManager::renderGlyphs(
+    SDL_Renderer& renderer,
+    const std::string& text,
+    int x, int y,
+    int scale
+) {
     int cursorX = x;
 
     for (char c : text) {
@@ -461,10 +498,87 @@ void UIManager::renderText(
         SDL_RenderCopy(&renderer, font.texture.get(), &src, &dst);
         cursorX += dst.w;
     }
+}
 
-    // Reset modulation to avoid affecting other draws
+const TextRun* UIManager::getTextRun(
+    SDL_Renderer& renderer,
+    const std::string& text,
+    SDL_Color color
+) {
+    TextRunKey key {
+        text,
+        (Uint32)color.r << 24 | (Uint32)color.g << 16 |
+        (Uint32)color.b << 8  | (Uint32)color.a
+    };
+
+    // Hit: move to front
+    auto it = textRunIndex.find(key);
+    if (it != textRunIndex.end()) {
+        textRuns.splice(textRuns.begin(), textRuns, it->second);
+        return &*it->second;
+    }
+
+    if (!SDL_RenderTargetSupported(&renderer))
+        return nullptr;
+
+    int w = static_cast<int>(text.size()) * font.glyphW;
+    int h = font.glyphH;
+    std::size_t bytes = static_cast<std::size_t>(w) * h * 4;
+    if (w <= 0 || h <= 0 || bytes > textRunBudget)
+        return nullptr;
+
+    // Evict least recently used runs until the new one fits
+    while (!textRuns.empty() && textRunBytes + bytes > textRunBudget) {
+        textRunBytes -= textRuns.back().bytes;
+        textRunIndex.erase(textRuns.back().key);
+        textRuns.pop_back();
+    }
+
+    SDL_Texture* raw = SDL_CreateTexture(&renderer, SDL_PIXELFORMAT_RGBA8888,
+        SDL_TEXTUREACCESS_TARGET, w, h);
+    if (!raw) {
+        std::cerr << "Failed to create text run texture: "
+                  << SDL_GetError() << "\n";
+        return nullptr;
+    }
+    SDL_SetTextureBlendMode(raw, SDL_BLENDMODE_BLEND);
+
+    // Bake: draw the glyphs once into the run texture
+    SDL_Texture* prevTarget = SDL_GetRenderTarget(&renderer);
+    Uint8 pr, pg, pb, pa;
+    SDL_GetRenderDrawColor(&renderer, &pr, &pg, &pb, &pa);
+
+    SDL_SetRenderTarget(&renderer, raw);
+    SDL_SetRenderDrawColor(&renderer, 0, 0, 0, 0);
+    SDL_RenderClear(&renderer);
+
+    // Copy the glyphs unblended: the run is blended once when drawn,
+    // so its alpha must not be applied here as well
+    SDL_BlendMode fontBlend;
+    SDL_GetTextureBlendMode(font.texture.get(), &fontBlend);
+    SDL_SetTextureBlendMode(font.texture.get(), SDL_BLENDMODE_NONE);
+    SDL_SetTextureColorMod(font.texture.get(), color.r, color.g, color.b);
+    SDL_SetTextureAlphaMod(font.texture.get(), color.a);
+    renderGlyphs(renderer, text, 0, 0, 1);
     SDL_SetTextureColorMod(font.texture.get(), 255, 255, 255);
     SDL_SetTextureAlphaMod(font.texture.get(), 255);
+    SDL_SetTextureBlendMode(font.texture.get(), fontBlend);
+
+    SDL_SetRenderTarget(&renderer, prevTarget);
+    SDL_SetRenderDrawColor(&renderer, pr, pg, pb, pa);
+
+    textRuns.push_front(TextRun{
+        key, SDLTexturePtr(raw, SDL_DestroyTexture), w, h, bytes
+    });
+    textRunIndex[key] = textRuns.begin();
+    textRunBytes += bytes;
+    return &textRuns.front();
+}
+
+void UIManager::clearTextCache(){
+    textRunIndex.clear();
+    textRuns.clear();
+    textRunBytes = 0;
 }
 
 void UIManager::renderPanelWeaponImage(
@@ -547,35 +661,36 @@ void UIManager::loadFont(const char* charsetAndFilePath, SDL_Renderer& renderer)
     std::string charset = input.substr(0, splitPos);
     std::string filePath = input.substr(splitPos + 1);
 
-    SDL_Texture* raw = IMG_LoadTexture(&renderer, filePath.c_str());
-    if (!raw) {
-        std::cerr << "Failed to load font texture: "
-                  << filePath << " | " << IMG_GetError() << "\n";
-        return;
-    }
+    AssetLoader::texture(&renderer, filePath, "HUD", [charset, filePath](SDLTexturePtr texture) {
+        if (!texture) {
+            std::cerr << "Failed to load font texture: "
+                      << filePath << " | " << IMG_GetError() << "\n";
+            return;
+        }
 
-    int texW, texH;
-    SDL_QueryTexture(raw, nullptr, nullptr, &texW, &texH);
+        int texW, texH;
+        SDL_QueryTexture(texture.get(), nullptr, nullptr, &texW, &texH);
 
-    int glyphCount = static_cast<int>(charset.size());
-    if (glyphCount == 0) {
-        std::cerr << "Font load error: Empty charset\n";
-        SDL_DestroyTexture(raw);
-        return;
-    }
+        int glyphCount = static_cast<int>(charset.size());
+        if (glyphCount == 0) {
+            std::cerr << "Font load error: Empty charset\n";
+            return;
+        }
 
-    // Assuming a single row font sheet
-    int glyphW = texW / glyphCount;
-    int glyphH = texH;
+        // Assuming a single row font sheet
+        int glyphW = texW / glyphCount;
+        int glyphH = texH;
 
-    font.texture = SDLTexturePtr(raw, SDL_DestroyTexture);
-    font.glyphW  = glyphW;
-    font.glyphH  = glyphH;
-    font.charset = charset;
+        clearTextCache(); // runs were baked from the previous font
+        font.texture = texture;
+        font.glyphW  = glyphW;
+        font.glyphH  = glyphH;
+        font.charset = charset;
 
-    std::cout << "Loaded bitmap font: "
-              << glyphCount << " glyphs ("
-              << glyphW << "x" << glyphH << ")\n";
+        std::cout << "Loaded bitmap font: "
+                  << glyphCount << " glyphs ("
+                  << glyphW << "x" << glyphH << ")\n";
+    });
 }
 
 // UI Helper
@@ -643,49 +758,47 @@ void UIManager::drawFilledRectWithBorder(
 }
 
 void UIManager::addPanelTextureW(WeaponType weapon, const char* filePath, SDL_Renderer& renderer){
-    SDL_Texture* raw = IMG_LoadTexture(&renderer, filePath);
-    if (!raw) {
-        std::cerr << "Failed to load Weapon Panel texture: "
-                  << filePath << " | " << IMG_GetError() << "\n";
-        return;
-    }
+    std::string path = filePath;
+    AssetLoader::texture(&renderer, path, "HUD", [weapon, path](SDLTexturePtr texture) {
+        if (!texture) {
+            std::cerr << "Failed to load Weapon Panel texture: "
+                      << path << " | " << IMG_GetError() << "\n";
+            return;
+        }
 
-    panelWeaponImage.emplace(
-        weapon,
-        SDLTexturePtr(raw, SDL_DestroyTexture)
-    );
-    int width = 0, height = 0;
-    if (SDL_QueryTexture(raw, nullptr, nullptr, &width, &height) != 0) {
-        std::cerr << "Failed to query texture: "
-                  << SDL_GetError() << "\n";
-        return;
-    }
+        panelWeaponImage.emplace(weapon, texture);
+        int width = 0, height = 0;
+        if (SDL_QueryTexture(texture.get(), nullptr, nullptr, &width, &height) != 0) {
+            std::cerr << "Failed to query texture: "
+                      << SDL_GetError() << "\n";
+            return;
+        }
 
-    panelWeaponImageWH[weapon] = std::make_pair(width, height);
+        panelWeaponImageWH[weapon] = std::make_pair(width, height);
+    });
 }
 
 void UIManager::addPanelTextureK(KeyType key, 
     const char* filePath, SDL_Renderer& renderer)
 {
-    SDL_Texture* raw = IMG_LoadTexture(&renderer, filePath);
-    if (!raw) {
-        std::cerr << "Failed to load Key Panel texture: "
-                  << filePath << " | " << IMG_GetError() << "\n";
-        return;
-    }
+    std::string path = filePath;
+    AssetLoader::texture(&renderer, path, "HUD", [key, path](SDLTexturePtr texture) {
+        if (!texture) {
+            std::cerr << "Failed to load Key Panel texture: "
+                      << path << " | " << IMG_GetError() << "\n";
+            return;
+        }
 
-    keyUITextures.emplace(
-        key,
-        SDLTexturePtr(raw, SDL_DestroyTexture)
-    );
-    int width = 0, height = 0;
-    if (SDL_QueryTexture(raw, nullptr, nullptr, &width, &height) != 0) {
-        std::cerr << "Failed to query texture: "
-                  << SDL_GetError() << "\n";
-        return;
-    }
+        keyUITextures.emplace(key, texture);
+        int width = 0, height = 0;
+        if (SDL_QueryTexture(texture.get(), nullptr, nullptr, &width, &height) != 0) {
+            std::cerr << "Failed to query texture: "
+                      << SDL_GetError() << "\n";
+            return;
+        }
 
-    keyUITexturesWH[key] = std::make_pair(width, height);
+        keyUITexturesWH[key] = std::make_pair(width, height);
+    });
 }
 
 std::pair<int, int> UIManager::getGlyphSize(){
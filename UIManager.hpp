@@ -1,6 +1,8 @@
 #pragma once
 #include <map>
 #include <vector>
+#include <list>
+#include <unordered_map>
 #include "SDL.h"
 #include "Game.hpp"
 
@@ -43,6 +45,30 @@ struct Notif{
     SDL_Color clr;
 };
 
+// A string baked once into its own texture (unscaled, colour applied)
+// so repeated HUD/menu labels cost a single SDL_RenderCopy.
+struct TextRunKey {
+    std::string text;
+    Uint32 rgba;
+    bool operator==(const TextRunKey& o) const {
+        return rgba == o.rgba && text == o.text;
+    }
+};
+
+struct TextRunHash {
+    std::size_t operator()(const TextRunKey& k) const {
+        return std::hash<std::string>()(k.text) ^ (std::hash<Uint32>()(k.rgba) << 1);
+    }
+};
+
+struct TextRun {
+    TextRunKey key;
+    SDLTexturePtr texture;
+    int width;
+    int height;
+    std::size_t bytes;
+};
+
 void drawFilledRectWithBorder(
     SDL_Renderer& renderer,
     const SDL_Rect& rect,
@@ -81,6 +107,8 @@ public:
         SDL_Color color
     );
 
+    static void clearTextCache();
+
     static void setWeapon(WeaponType weapon);
     static void setAmmo(const char, int num);
     static void setHealth(int hp);
@@ -97,6 +125,10 @@ public:
     static void updateNotifications();
     static void notify(std::string text, SDL_Color);
     static void reset();
+    // Notifications and the avatar wake up on the game's timer wheel
+    // (nullptr detaches); what clear() drops is re-armed on update
+    static void useTimers(TimerWheel* wheel) { timers = wheel; }
+    static void seedRandom(uint64_t seed) { rng = Random(seed); }
     static void drawFilledRectWithBorder(
         SDL_Renderer& renderer,
         const SDL_Rect& rect,
@@ -122,6 +154,17 @@ private:
     static const int IDLE_FRAME = 0;
 
     static BitmapFont font;
+
+    // Text run cache (LRU, most recent at front)
+    static std::list<TextRun> textRuns;
+    static std::unordered_map<TextRunKey, std::list<TextRun>::iterator,
+        TextRunHash> textRunIndex;
+    static std::size_t textRunBytes;
+    static constexpr std::size_t textRunBudget = 4 * 1024 * 1024; // bytes
+    static const TextRun* getTextRun(SDL_Renderer& renderer,
+        const std::string& text, SDL_Color color);
+    static void renderGlyphs(SDL_Renderer& renderer, const std::string& text,
+        int x, int y, int scale);
     static SDL_Rect panel;
     static int panelHeight, panelBorderThickness;
     static SDL_Color panelFillColor, panelBorderColor;
@@ -134,11 +177,15 @@ private:
     static std::map<KeyType, std::pair<int, int>> keyUITexturesWH;
 
     static std::vector<Notif> UINotification;
-    static float notifUpdateTimer;
     static constexpr float notifDuration = 1.0f; 
 
     static std::vector<UIAnimation> AvatarAnimation;
     static int avatarFrame, curr_avatar_state;
-    static float avatarTimer, avatarFrameDuration;
+    static float avatarFrameDuration;
+    static void nextAvatarFrame();
+
+    static TimerWheel* timers;
+    static TimerWheel::TimerId notifTimer, avatarTimer;
+    static Random rng; // avatar frame picks
     static std::pair<int, int> AvatarDimensions;
 };
@@ -2,8 +2,19 @@
 #include "UIManager.hpp"
 #include "AudioManager.hpp"
 #include "MenuManager.hpp"
+#include "JobSystem.hpp"
 void Game::update(float deltaTime)
 {
+    TickInput input;
+    if (!nextTickInput(input)) {
+        isRunning = false; // demo played out
+        return;
+    }
+    applyInput(input);
+
+    // Due timers first: door auto-close, weapon cooldown, level exit
+    timers.tick();
+
     // Normalize movement direction
     float lengthSquared = playerMoveDirection.first * playerMoveDirection.first +
     playerMoveDirection.second * playerMoveDirection.second;
@@ -18,45 +29,23 @@ void Game::update(float deltaTime)
         playerMoveDirection.second /= length;
     }
 
-    // Collision detection and position update
-    float newX = playerPosition.first + playerMoveDirection.first * playerSpeed * deltaTime;
-    float newY = playerPosition.second + playerMoveDirection.second * playerSpeed * deltaTime;
-    int mx = (int)newX;
-    int my = (int)playerPosition.second;
-    if (my < 0 || my >= Map.size()){
-        std::cout << "Y out of bounds: " << my << "\n";
-        return;
-    }
-    if (mx < 0 || mx >= Map[my].size()) {
-        std::cout << "X out of bounds: " << mx << "\n";
-        return;
-    }
-    int tileX = Map[(int)playerPosition.second][(int)(newX + playerSquareSize * (newX>playerPosition.first?1:-1))];
-    int tileY = Map[(int)(newY + playerSquareSize * (newY>playerPosition.second?1:-1))][(int)playerPosition.first];
-    if (tileX == 0 ||
-        (isDoor(tileX) &&
-        doors[{
-            (int)(newX + playerSquareSize * (newX > playerPosition.first ?1:-1)),
-            (int)playerPosition.second
-                }]
-            .openAmount == 1.0f))
-    {
-        if (!collidesWithEnemy(newX, playerPosition.second)) {
-            playerPosition.first = newX;
-        }
-    }
-
-    if (tileY == 0 ||
-        (isDoor(tileY) &&
-        doors[{
-            (int)playerPosition.first,
-            (int)(newY + playerSquareSize * (newY > playerPosition.second ?1:-1)),
-                }]
-            .openAmount == 1.0f))
-    {
-        if (!collidesWithEnemy(playerPosition.first, newY)) {
-            playerPosition.second = newY;
-        }
+    // Collision detection and position update: the player's box is
+    // swept against the solidity bitset one axis at a time (so it
+    // slides along walls), then checked against enemies. Walls stay
+    // playerSquareSize away ahead, as with the old probes; across the
+    // move the box is half that, so corridors need no exact centring.
+    float stepX = playerMoveDirection.first * playerSpeed * deltaTime;
+    float stepY = playerMoveDirection.second * playerSpeed * deltaTime;
+    // Both axes go through one sweep, which keeps the clearance at
+    // corners; an enemy in the way on X leaves Y to move alone.
+    float reach = playerSquareSize, half = playerSquareSize * 0.5f;
+    float x = playerPosition.first, y = playerPosition.second;
+    std::pair<float, float> next = collision.sweep(x, y, reach, half, stepX, stepY);
+    if (collidesWithEnemy(next.first, y))
+        next = collision.sweep(x, y, reach, half, 0.0f, stepY);
+    playerPosition.first = next.first;
+    if (!collidesWithEnemy(next.first, next.second)) {
+        playerPosition.second = next.second;
     }
 
     // new posn
@@ -64,135 +53,164 @@ void Game::update(float deltaTime)
     int newMapY = playerPosition.second;
 
     if(newMapX != mapX || newMapY != mapY){
-        if(isDoor(Map[mapY][mapX]) && 
-        doors.count({mapX, mapY})){
-            doors[{mapX, mapY}].vacant = true;
-            std::cout << "Vacated\n";
+        Door* left = doorAt(mapX, mapY);
+        Door* entered = doorAt(newMapX, newMapY);
+        if(isDoor(Map[mapY][mapX]) && left){
+            left->vacant = true;
+            if (!headless) std::cout << "Vacated\n";
         }
-        if(isDoor(Map[newMapY][newMapX]) && 
-        doors.count({newMapX, newMapY})){
-            doors[{newMapX, newMapY}].vacant = false;
-            std::cout<< "Filled\n";
+        if(isDoor(Map[newMapY][newMapX]) && entered){
+            entered->vacant = false;
+            if (!headless) std::cout<< "Filled\n";
         }
     }
 
-    // Update enemies
-    for(const std::unique_ptr<Enemy>& e : enemies){
-        // last frame posn
-        int EX = e->get_position().first;
-        int EY = e->get_position().second;
+    // Update enemies (batch passes over the enemy store)
+    int enemyCount = enemies.size();
+    updateActiveAreas();
+    updatePlayerVisibility();
+    updatePlayerFlowField();
+    enemies.chaseField = &playerFlow;
+    std::vector<int>& lastEX = enemyLastTileX; // last frame tiles
+    std::vector<int>& lastEY = enemyLastTileY;
+    lastEX.resize(enemyCount);
+    lastEY.resize(enemyCount);
+    for(int i = 0; i < enemyCount; i++){
+        lastEX[i] = enemies.posX[i];
+        lastEY[i] = enemies.posY[i];
+    }
 
-        auto epos = e->askGameToMove(deltaTime);
-        std::pair<int, int> coor;
-        int hasWall = canMoveTo(epos.first, epos.second, e->get_size(), coor);
-        if(hasWall > 0){
-            e->allowWalkNextFrame();
-        }
-        else{
-            e->cancelWalkThisFrame(hasWall);
+    // Where would everyone walk, and is it free? (reads the map and
+    // doors only, each enemy writes its own slot)
+    enemies.schedule(deltaTime, playerPosition);
+    enemies.proposeMoves(enemyMoveX, enemyMoveY);
+    const std::vector<int>& active = enemies.active;
+    enemyHalf.resize(enemyCount);
+    enemyHit.resize(enemyCount);
+    for(int i : active)
+        enemyHalf[i] = enemies.get_size(i) * 0.5f;
+    JobSystem::parallelFor((int)active.size(), 32, [&](int begin, int end){
+        collision.checkBoxes(active.data() + begin, end - begin,
+            enemyMoveX.data(), enemyMoveY.data(), enemyHalf.data(), enemyHit.data());
+        for(int k = begin; k < end; k++){
+            int i = active[k];
+            std::pair<int, int> coor = {0, 0};
+            // 1 free, 0 wall (or someone in the way), -1 closed door
+            int hasWall = 1;
+            if(enemyHit[i] != -1){
+                hasWall = 0;
+                if(enemyHit[i] >= 0){
+                    coor = tileOf(enemyHit[i]);
+                    if(doorAt(coor.first, coor.second))
+                        hasWall = -1;
+                }
+            }
+            else if(enemyBlockedByPlayer(i, enemyMoveX[i], enemyMoveY[i]) ||
+                    enemyBlockedByEnemy(i, enemyMoveX[i], enemyMoveY[i]))
+                hasWall = 0;
+            if(hasWall > 0){
+                enemies.allowWalkNextFrame(i);
+            }
+            else{
+                enemies.cancelWalkThisFrame(i, hasWall);
+                enemies.doorX[i] = coor.first;
+                enemies.doorY[i] = coor.second;
+            }
         }
-        e->_process(deltaTime, playerPosition, playerAngle);
-        if(e->get_wantToOpenDoor()){
-            std::cout<<"Enemy want to open door at ("<<coor.first<<", "
-            <<coor.second<<")"<<std::endl;
-            if(doors.count(coor) && !doors[coor].locked && 
-            !(doors[coor].opening || doors[coor].closing)){
-                doors[coor].opening = true;
+    });
+
+    // Timers, thinking, animation and walking for every enemy (parallel)
+    enemies.process(playerPosition, playerAngle);
+
+    // Gunfire alerts everyone within earshot
+    if(shotThisFrame && currentWeapon > 1)
+        propagateNoise(playerPosition.first, playerPosition.second,
+            weapons[currentWeapon].alertRadius);
+
+    // Resolve door, damage and alert intents serially, in index order
+
+    for(int i = 0; i < enemyCount; i++){
+        if(enemies.dormant[i]) continue; // frozen: nothing to resolve
+        armEnemyThink(i);
+        auto epos = enemies.get_position(i);
+        enemyIndex.update(i, epos.first, epos.second);
+        placeEnemyInArea(i);
+        if(enemies.get_wantToOpenDoor(i)){
+            std::pair<int, int> coor = {enemies.doorX[i], enemies.doorY[i]};
+            if(!headless)
+                std::cout<<"Enemy want to open door at ("<<coor.first<<", "
+                <<coor.second<<")\n";
+            Door* door = doorAt(coor);
+            if(door && !door->locked && 
+            !(door->opening || door->closing)){
+                openDoor(coor);
             }
-            else if(doors.count(coor)==0){
+            else if(!door){
                 std::cerr<<"No door at ("<<coor.first<<", "<<coor.second<<")\n";
             }
-            e->reset_wantToOpenThisFrame();
+            enemies.reset_wantToOpenThisFrame(i);
         }
         // Update canSeePlayer
-        bool x = rayCastEnemyToPlayer(*e, false);
-        e->updateCanSeePlayer(x);
-        //if(x) std::cout << "Enemy at (" << e->get_position().first << ", " << e->get_position().second << ") can see player.\n";
-        int dmg = e->getDamageThisFrame();
-        e->clearDamageThisFrame();
+        enemies.updateCanSeePlayer(i, enemyCanSeePlayer(epos.first, epos.second));
+        int dmg = enemies.getDamageThisFrame(i);
+        enemies.clearDamageThisFrame(i);
         if(dmg > 0){
             health -= dmg;
             if(health < 0) health = 0;
-            std::cout << "health of player : "<<health<<std::endl;
-        }
-        // Update Alerts
-        if(shotThisFrame && currentWeapon > 1 && !e->isAlerted()){
-            float dist = distSq(playerPosition, e->get_position());
-            dist = pow(dist, 0.5f);
-            if(dist <= weapons[currentWeapon].alertRadius)
-                e->alert();
+            if(!headless)
+                std::cout << "health of player : "<<health<<"\n";
         }
-
-        // Enemy position relative to player 
-        auto [ex, ey] = e->get_position();
-
-        float dx = ex - playerPosition.first;
-        float dy = ey - playerPosition.second;
-
-        float enemyDist = sqrt(dx*dx + dy*dy);
-
-        // Angle between player view and enemy 
-        float enemyAngle = atan2(dy, dx) - playerAngle;
-
-        while (enemyAngle > PI)  enemyAngle -= 2 * PI;
-        while (enemyAngle < -PI) enemyAngle += 2 * PI;
-
-        // Check if enemy is inside FOV 
-        int frame = e->get_current_frame(), dir = e->get_dirn_num();
-        auto it = enemyTextures.find({frame, dir});
-        if (it == enemyTextures.end()) continue;
-        AllSpriteTextures[e->get_spriteID()].texture = it->second;
-        AllSpriteTextures[e->get_spriteID()].position = e->get_position();
-
         // new position;
-        int newEX = e->get_position().first;
-        int newEY = e->get_position().second;
+        int EX = lastEX[i], EY = lastEY[i];
+        int newEX = epos.first;
+        int newEY = epos.second;
 
-        if(newEX != EX || newEY != EY || e->get_isDead()){
-            if(isDoor(Map[EY][EX]) && 
-            doors.count({EX, EY}) &&
-            !doors[{EX, EY}].vacant){
-                doors[{EX, EY}].vacant = true;
-                std::cout << "ENEMY Vacated\n";
+        if(newEX != EX || newEY != EY || enemies.get_isDead(i)){
+            Door* left = doorAt(EX, EY);
+            Door* entered = doorAt(newEX, newEY);
+            if(isDoor(Map[EY][EX]) && left && !left->vacant){
+                left->vacant = true;
+                if (!headless) std::cout << "ENEMY Vacated\n";
             }
-            if(isDoor(Map[newEY][newEX]) && 
-            doors.count({newEX, newEY}) && !e->get_isDead()){
-                doors[{newEX, newEY}].vacant = false;
-                std::cout<< "ENEMY Filled\n";
+            if(isDoor(Map[newEY][newEX]) && entered && !enemies.get_isDead(i)){
+                entered->vacant = false;
+                if (!headless) std::cout<< "ENEMY Filled\n";
             }
         }
-    }
-    if(hasShot){
-        fireCooldown += deltaTime;
-        if(fireCooldown >= weapons[currentWeapon].coolDownTime){
-            hasShot = false;
-            shotThisFrame = false;
-        }
-    }
 
+        // Sprite for this frame and direction; the position follows
+        // even when the archetype has no texture for it
+        Entity e = enemies.get_entity(i);
+        positions.get(e) = Position{epos.first, epos.second};
+        Sprite* sprite = sprites.find(e);
+        if (!sprite || enemies.archetype[i] >= enemyVisuals.size()) continue;
+        const EnemyVisuals& visuals = enemyVisuals[enemies.archetype[i]];
+        int frame = enemies.get_current_frame(i), dir = enemies.get_dirn_num(i);
+        auto it = visuals.textures.find({frame, dir});
+        if (it == visuals.textures.end()) continue;
+        sprite->texture = it->second;
+        sprite->textureWidth = visuals.width;
+        sprite->textureHeight = visuals.height;
+    }
+    // Shots are traced against post-move positions, independent of render
+    if(shotThisFrame)
+        resolveShot();
 
-    // Update doors
-    for (auto& [pos, d] : doors)
+    // Update doors: only the ones moving (auto-close is on the wheel)
+    for (size_t k = 0; k < activeDoors.size(); )
     {
+        auto pos = tileOf(activeDoors[k]);
+        Door& d = doors.get(activeDoors[k]);
+        bool wasOpen = d.openAmount >= 1.0f;
+        bool wasShut = d.openAmount <= 0.0f;
         if (d.opening) {
             d.openAmount += d.transitionSpeed * deltaTime;
             if (d.openAmount >= 1.0f) {
                 d.openAmount = 1.0f;
                 d.opening = false;
+                scheduleDoorClose(pos);
             }
         }
-        else if (d.openAmount == 1.0f){
-            d.openTimer += deltaTime;
-            if(d.openTimer > d.openDuration){
-                    if(d.vacant){
-                        d.closing = true; 
-                        d.openTimer = 0.0f;
-                        AudioManager::playSFX("door_close", MIX_MAX_VOLUME);
-                    } else 
-                    {d.openTimer = 0.0f; 
-                    std::cout<<"Restarting timer\n";}
-            } 
-        }
         if(d.closing){
             d.openAmount -= d.transitionSpeed * deltaTime;
             if(d.openAmount < 0.0f){
@@ -200,117 +218,27 @@ void Game::update(float deltaTime)
                 d.openAmount = 0.0f;
             }
         }
-    }
-
-    // Update keys pickup
-    for (const auto& [keyType, pos] : keysPositions) {
-        if(playerHasKey(keyType))
-            continue;
-        auto [kx, ky] = pos;
-        float keyX = kx + 0.5f;
-        float keyY = ky + 0.5f;
-        
-        float dx = keyX - playerPosition.first;
-        float dy = keyY - playerPosition.second;
-        float distanceSq = dx * dx + dy * dy;
-
-        if (distanceSq < keyRadius * keyRadius) {
-            acquireKey(keyType);
-            UIManager::addKey(static_cast<KeyType>(keyType-1));
-            // Remove key from map
-            AllSpriteTextures[keyTypeToSpriteID[keyType]].active = false;
-            break; // Exit loop since we modified the map
+        if (wasShut != (d.openAmount <= 0.0f)) {
+            areas.setDoorOpen(pos.first, pos.second, d.openAmount > 0.0f);
+            areaVersion++;
         }
-    }
-
-    // Update weapons pickup
-    for (const auto& [weaponType, pos] : weaponsPositions) {
-        if(playerHasWeapon(weaponType))
-            continue;
-        auto [wx, wy] = pos;
-        float weaponX = wx + 0.5f;
-        float weaponY = wy + 0.5f;
-
-        float dx = weaponX - playerPosition.first;
-        float dy = weaponY - playerPosition.second;
-        float distanceSq = dx * dx + dy * dy;
-
-        if (distanceSq < weaponRadius * weaponRadius) {
-            acquireWeapon(weaponType);
-            // Remove weapon from map
-            AllSpriteTextures[weaponTypeToSpriteID[weaponType]].active = false;
-            break; // Exit loop since we modified the map
+        if (wasOpen != (d.openAmount >= 1.0f)) {
+            doorVersion++;
+            collision.setSolid(pos.first, pos.second, d.openAmount < 1.0f);
+            if (d.locked)
+                routeGraph.setDoorBlocked(pos.first, pos.second, d.openAmount < 1.0f);
         }
-    }
-
-    // Update health pack pickup
-    for (const auto& [key, pos] : HealthPackPositions) {
-        if(health >= 100)
+        if (!d.opening && !d.closing) {
+            d.active = false; // at rest: drop out of the active set
+            activeDoors[k] = activeDoors.back();
+            activeDoors.pop_back();
             continue;
-        auto [hpType, spriteID] = key;
-            
-        if(!AllSpriteTextures[spriteID].active)
-            continue; // already picked up
-        auto [hx, hy] = pos;
-        float healthPackX = hx + 0.5f;
-        float healthPackY = hy + 0.5f;
-        float dx = healthPackX - playerPosition.first;
-        float dy = healthPackY - playerPosition.second;
-        float distanceSq = dx * dx + dy * dy;
-        if (distanceSq < healthPackRadius * healthPackRadius) {
-            int healAmount = healAmounts[hpType];
-            health += healAmount;
-            if(health > 100) health = 100;
-            std::cout<<"Health : "<<health<<std::endl;
-            AudioManager::playSFX("pickup", MIX_MAX_VOLUME / 2);
-            // Remove health pack from map
-            AllSpriteTextures[spriteID].active = false;
-            break; // Exit loop since we modified the map
-        }
-    }
-
-    // Update Ammopack Pickups
-    for (const auto& [key, pos] : AmmoPackPositions){
-        auto [Type, spriteID] = key;
-        int weaponType = 2 + ((Type+1) % 2);
-        if(!playerHasWeapon(weaponType)){
-            continue; // Player doesn't have the weapon
-        }
-        if(!AllSpriteTextures[spriteID].active){
-            continue; // Already picked up
-        }
-        auto [ax, ay] = pos;
-        float x = ax + 0.5f;
-        float y = ay + 0.5f;
-        float dx = x - playerPosition.first;
-        float dy = y - playerPosition.second;
-        float distanceSq = dx * dx + dy * dy;
-        if(distanceSq < ammoPackRadius * ammoPackRadius){
-            if(weapons[weaponType].ammo >= weapons[weaponType].maxAmmo){
-                weapons[weaponType].ammo = weapons[weaponType].maxAmmo;
-                continue;
-            }
-            int amt = ammoAmounts[Type];
-            weapons[weaponType].ammo += amt;
-            if(weapons[weaponType].ammo >= weapons[weaponType].maxAmmo){
-                weapons[weaponType].ammo = weapons[weaponType].maxAmmo;
-            }
-            std::cout<<"Ammo of weapon num "<<weaponType<<" = "<<weapons[weaponType].ammo<<std::endl;
-            AudioManager::playSFX("pickup", MIX_MAX_VOLUME / 2);
-            // Remove health pack from map
-            AllSpriteTextures[spriteID].active = false;
-            break; // Exit loop since we modified the map
         }
+        k++;
     }
 
-    // ------- Update Textures to be rendered ---------
-    renderOrder.clear();
-        
-    for (int i = 0; i < AllSpriteTextures.size(); ++i) {
-        if (AllSpriteTextures[i].active){
-                renderOrder.push_back(i);
-        }
-    }
+    // Pickups around the player (collected ones hide their sprite)
+    collectPickups();
 
     if(currentWeapon == 1 && weaponChangedThisFrame){
         UIManager::setWeapon(WeaponType::Knife);
@@ -330,6 +258,7 @@ void Game::update(float deltaTime)
     }
     if(shotThisFrame){
         UIManager::animateOneShot();
+        shotThisFrame = false;
     }
     UIManager::setHealth(health);
     UIManager::update(deltaTime);
@@ -339,15 +268,6 @@ void Game::update(float deltaTime)
         if (musicTrack > numOfTracks) musicTrack = 1;
         AudioManager::playMusic(std::to_string(musicTrack), 0);
     }
-    if(currentSwitchState == SwitchState::OFF){
-        levelCrossTimer += deltaTime;
-        if(levelCrossTimer >= levelCrossDuration){
-            levelCrossTimer = 0.0f;
-            currentSwitchState = SwitchState::ON;
-            state = GameState::GAMEWON;
-            MenuManager::setMenu(Menu::GAME_WON);
-        }
-    }
     if(health <= 0){
         state = GameState::GAMELOOSE;
         MenuManager::setMenu(Menu::GAME_LOSE);
@@ -0,0 +1,72 @@
+#include "Visibility.hpp"
+#include <algorithm>
+
+// Octant transforms: (dx, dy) in octant space -> map offset
+static const int octants[8][4] = {
+    { 1,  0,  0,  1}, { 0,  1,  1,  0}, { 0, -1,  1,  0}, {-1,  0,  0,  1},
+    {-1,  0,  0, -1}, { 0, -1, -1,  0}, { 0,  1, -1,  0}, { 1,  0,  0, -1}
+};
+
+void VisibilityField::compute(int ox_, int oy_, int w, int h, int radius_,
+    const OpaqueFn& opaque)
+{
+    ox = ox_;
+    oy = oy_;
+    radius = std::min(radius_, std::max(w, h));
+    if (w != width || h != height || visible.empty()) {
+        width = w;
+        height = h;
+        visible.assign(static_cast<size_t>(w) * h, 0);
+    }
+    else {
+        for (size_t t : lit)
+            visible[t] = 0;
+    }
+    lit.clear();
+
+    mark(ox, oy);
+    for (const auto& o : octants)
+        castLight(1, 1.0f, 0.0f, o[0], o[1], o[2], o[3], opaque);
+}
+
+void VisibilityField::castLight(int row, float start, float end,
+    int xx, int xy, int yx, int yy, const OpaqueFn& opaque)
+{
+    if (start < end) return;
+
+    float newStart = 0.0f;
+    for (int j = row; j <= radius; j++) {
+        int dy = -j;
+        bool blocked = false;
+        for (int dx = -j; dx <= 0; dx++) {
+            // Slopes through the tile's corners
+            float leftSlope  = (dx - 0.5f) / (dy + 0.5f);
+            float rightSlope = (dx + 0.5f) / (dy - 0.5f);
+            if (start < rightSlope) continue;
+            if (end > leftSlope) break;
+
+            int x = ox + dx * xx + dy * xy;
+            int y = oy + dx * yx + dy * yy;
+            bool outside = x < 0 || y < 0 || x >= width || y >= height;
+            bool wall = outside || opaque(x, y);
+            if (!outside)
+                mark(x, y);
+
+            if (blocked) {
+                if (wall) {
+                    newStart = rightSlope;
+                    continue;
+                }
+                blocked = false;
+                start = newStart;
+            }
+            else if (wall && j < radius) {
+                // Light the part of the next row this wall doesn't cover
+                blocked = true;
+                castLight(j + 1, start, leftSlope, xx, xy, yx, yy, opaque);
+                newStart = rightSlope;
+            }
+        }
+        if (blocked) break;
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <functional>
+#include <vector>
+#include <cstdint>
+
+// Tiles visible from one origin tile, built by recursive shadow casting
+// over the map grid. Computed once per origin (the player's tile) and
+// then queried per enemy, so line-of-sight cost does not grow with the
+// number of enemies.
+class VisibilityField {
+public:
+    using OpaqueFn = std::function<bool(int, int)>;
+
+    // Recompute from (ox, oy) over a width x height grid, out to radius
+    // tiles. Opaque tiles are themselves marked visible (their faces are
+    // seen). Only the tiles the last cast marked are cleared, so the cost
+    // follows the radius, not the map.
+    void compute(int ox, int oy, int width, int height, int radius,
+                 const OpaqueFn& opaque);
+
+    bool isVisible(int x, int y) const {
+        if (x < 0 || y < 0 || x >= width || y >= height) return false;
+        return visible[static_cast<size_t>(y) * width + x] != 0;
+    }
+    int originX() const { return ox; }
+    int originY() const { return oy; }
+    bool empty() const { return visible.empty(); }
+
+private:
+    void castLight(int row, float start, float end,
+                   int xx, int xy, int yx, int yy, const OpaqueFn& opaque);
+    void mark(int x, int y) {
+        if (x < 0 || y < 0 || x >= width || y >= height) return;
+        size_t t = static_cast<size_t>(y) * width + x;
+        if (!visible[t]) {
+            visible[t] = 1;
+            lit.push_back(t);
+        }
+    }
+
+    int ox = -1, oy = -1;
+    int width = 0, height = 0, radius = 0;
+    std::vector<uint8_t> visible;
+    std::vector<size_t> lit; // tiles marked by the last cast
+};
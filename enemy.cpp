@@ -1,11 +1,14 @@
 #include "enemy.hpp"
 #include "AudioManager.hpp"
+#include "JobSystem.hpp"
 #include <iostream>
 #include <algorithm>
 #include <cctype>
 #include <cmath>
 #include <utility>
 #include <cstdlib>
+#include <fstream>
+#include <sstream>
 
 static float normalizeAngle(float a) {
     while (a <= -M_PI) a += 2.0f * M_PI;
@@ -19,137 +22,291 @@ static std::string to_lower(std::string s) {
     return s;
 }
 
-Enemy::Enemy(float x, float y, float theta)
-    : position(x, y), angle(theta) {}
-
-std::pair<float, float> Enemy::get_position() const{
-    return position;
+EnemyArchetype::EnemyArchetype() {
+    animations.resize(ENEMY_STATE_COUNT);
+    animations[ENEMY_IDLE]  = {0};
+    animations[ENEMY_WALK]  = {1, 2, 3, 4};
+    animations[ENEMY_SHOOT] = {5, 6, 7};
+    animations[ENEMY_PAIN]  = {8, 9};
+    animations[ENEMY_DEAD]  = {10, 11, 12, 13};
 }
 
-float Enemy::get_angle() const{
-    return angle;
+EnemyStore::EnemyStore() {
+    archetypes.emplace_back(); // built-in guard
 }
 
-void Enemy::_process(float deltaTime, const std::pair<float, float>& playerPosition, float playerAngle) {
-    if(isDead) return;
-    updateDirnNumWrt(playerPosition);
-    if (!stateLocked)
-        thinkTimer += deltaTime;
-    
-    if(thinkTimer > thinkInterval){
-        thinkTimer = 0.0f;
-        think(playerPosition, playerAngle);
+bool EnemyStore::loadArchetypes(const std::string& f)
+{
+    const char* filePath = f.c_str();
+    std::ifstream file(filePath);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open enemy types file: " << filePath << '\n';
+        return false;
     }
 
-    if(state != ENEMY_IDLE){
-        fracTime += deltaTime;
-        while (fracTime > DurationPerSprite) {
-            moveNextFrame();
-            fracTime -= DurationPerSprite;
-            if(frameIndex == Animations[state].size()-1){
-                if(state==ENEMY_DEAD){
-                    isDead = true;
-                    stateLocked = true;
-                    
-                    return;
-                }
-                if(!walking){   // Pain or shooting end
-                    stateLocked = false;
-                    thinkTimer = 0.0f;
-                    fracTime = 0.0f;
-                    if(state == ENEMY_SHOOT){
-                        damageThisFrame = rollEnemyDamage();
-                        std::cout<<"Enemy giving damage "<<damageThisFrame
-                        <<std::endl;
-                    }
-                }
-            }
+    static const std::map<std::string, EnemyState> animKeys = {
+        {"idle", ENEMY_IDLE}, {"walk", ENEMY_WALK}, {"shoot", ENEMY_SHOOT},
+        {"pain", ENEMY_PAIN}, {"dead", ENEMY_DEAD}
+    };
+
+    std::vector<EnemyArchetype> loaded;
+    std::string line;
+    int lineNumber = 0;
+
+    while (std::getline(file, line)) {
+        lineNumber++;
+        auto comment_pos = line.find('#');
+        if (comment_pos != std::string::npos)
+            line = line.substr(0, comment_pos);
+
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos)
+            continue;
+        size_t end = line.find_last_not_of(" \t\r");
+        line = line.substr(start, end - start + 1);
+
+        // [name] starts a new type
+        if (line.front() == '[' && line.back() == ']') {
+            loaded.emplace_back();
+            loaded.back().name = to_lower(line.substr(1, line.size() - 2));
+            continue;
         }
-    }
-    else{
-        fracTime = 0.0f;
-        frameIndex = 0;
-        currentFrame = Animations[state][0];
-    }
-    if (walking) {
-        float dx = destinationOfWalk.first  - position.first;
-        float dy = destinationOfWalk.second - position.second;
-
-        float distSq = dx*dx + dy*dy;
-        float step   = moveSpeed * deltaTime;
-
-        if (distSq <= step*step) {
-            position = destinationOfWalk;
-            walking = false;
-            setAnimState(ENEMY_IDLE, false);
-            stateLocked = false;
-        } else {
-            if (canWalkThisFrame > 0) {
-                position.first  += step * std::cos(angle);
-                position.second -= step * std::sin(angle);
-            }
-            else{
-                if(canWalkThisFrame < 0 && canOpenDoor())
-                    openDoor();
-                
-                destinationOfWalk = position; // cancel walk
-                walking = false;
-                setAnimState(ENEMY_IDLE, false);
-                stateLocked = false;
-            }
+
+        // Format: <key> : <value>
+        size_t colon = line.find(':');
+        if (colon == std::string::npos || loaded.empty()) {
+            std::cerr << "Invalid enemy type entry at line " << lineNumber << "\n";
+            continue;
         }
+        std::string key = line.substr(0, colon);
+        key.erase(key.find_last_not_of(" \t") + 1);
+        key = to_lower(key);
+        std::istringstream value(line.substr(colon + 1));
+
+        EnemyArchetype& a = loaded.back();
+        EnemyStats& s = a.stats;
+        auto anim = animKeys.find(key);
+        if (anim != animKeys.end()) {
+            auto& frames = a.animations[anim->second];
+            frames.clear();
+            int frame;
+            while (value >> frame) frames.push_back(frame);
+            if (frames.empty()) frames.push_back(0);
+        }
+        else if (key == "health")         value >> s.maxHealth;
+        else if (key == "basedamage")     value >> s.baseDamage;
+        else if (key == "damagespread")   value >> s.damageSpread;
+        else if (key == "attackchance")   value >> s.attackChanceDivisor;
+        else if (key == "accuracy")       value >> s.accuracyDivisor;
+        else if (key == "painchance")     value >> s.painChanceDivisor;
+        else if (key == "dooropenchance") value >> s.doorOpenChanceDivisor;
+        else if (key == "attackrange")    value >> s.attackRange;
+        else if (key == "walksegment")    value >> s.walk_segment_length;
+        else if (key == "thinkinterval")  value >> s.thinkInterval;
+        else if (key == "size")           value >> s.sze;
+        else if (key == "movespeed")      value >> s.moveSpeed;
+        else if (key == "frameduration")  value >> s.DurationPerSprite;
+        else if (key == "walkangleerror") {
+            float degrees;
+            if (value >> degrees) s.walk_angle_error = degrees * M_PI / 180.0f;
+        }
+        else if (key == "frames")      value >> a.framesFile;
+        else if (key == "sfx_alert")   value >> a.alertSFX;
+        else if (key == "sfx_pain")    value >> a.painSFX;
+        else if (key == "sfx_shoot")   value >> a.shootSFX;
+        else if (key == "sfx_die") {
+            a.deathSFX.clear();
+            std::string name;
+            while (value >> name) a.deathSFX.push_back(name);
+        }
+        else {
+            std::cerr << "Unknown enemy type key '" << key
+                      << "' at line " << lineNumber << "\n";
+        }
+    }
+
+    if (loaded.empty()) {
+        std::cerr << "No enemy types in " << filePath << ", keeping built-in guard\n";
+        return false;
     }
+    archetypes = std::move(loaded);
+    std::cout << "Loaded " << archetypes.size() << " enemy types\n";
+    return true;
 }
-std::pair<float, float> Enemy::askGameToMove(float deltaTime){
-    float step = moveSpeed * deltaTime; 
-    float newX = position.first + step * std::cos(angle);
-    float newY = position.second - step * std::sin(angle);
-    return std::make_pair(newX, newY);
+
+int EnemyStore::findArchetype(const std::string& name) const {
+    std::string low = to_lower(name);
+    for (size_t t = 0; t < archetypes.size(); t++)
+        if (archetypes[t].name == low)
+            return static_cast<int>(t);
+    return -1;
 }
-void Enemy::addFrame(EnemyState s, int frame) {
-    Animations[s].push_back(frame);
+
+int EnemyStore::add(float x, float y, float theta, int type) {
+    if (type < 0 || type >= (int)archetypes.size())
+        type = 0;
+    const EnemyArchetype& at = archetypes[type];
+
+    posX.push_back(x);
+    posY.push_back(y);
+    angle.push_back(theta);
+    destX.push_back(x);
+    destY.push_back(y);
+    canWalk.push_back(1);
+    doorX.push_back(0);
+    doorY.push_back(0);
+
+    state.push_back(ENEMY_IDLE);
+    fracTime.push_back(0.0f);
+    thinkDue.push_back(0);
+    thinkRearm.push_back(0);
+    health.push_back(at.stats.maxHealth);
+    frameIndex.push_back(0);
+    currentFrame.push_back(at.animations[ENEMY_IDLE][0]);
+    dirNum.push_back(0);
+    damageThisFrame.push_back(0);
+
+    walking.push_back(0);
+    alerted.push_back(0);
+    canSeePlayer.push_back(0);
+    justTookDamage.push_back(0);
+    dead.push_back(0);
+    stateLocked.push_back(0);
+    wantsDoor.push_back(0);
+
+    entity.push_back(-1);
+    archetype.push_back(static_cast<uint16_t>(type));
+    rng.push_back(seedFor(size() - 1));
+    routes.emplace_back();
+    cues.emplace_back();
+    lod.push_back(LOD_NEAR);
+    ticking.push_back(0);
+    dormant.push_back(0);
+    tickDt.push_back(0.0f);
+    phase.push_back(0);
+    spreadPhase(size() - 1);
+    return size() - 1;
 }
 
-void Enemy::addFrames(const std::map<EnemyState, std::vector<int>>& Anim) {
-    Animations = Anim;
+void EnemyStore::clear() {
+    for (auto* v : {&posX, &posY, &angle, &destX, &destY, &fracTime})
+        v->clear();
+    for (auto* v : {&doorX, &doorY, &health, &frameIndex, &currentFrame,
+                    &dirNum, &damageThisFrame, &entity})
+        v->clear();
+    archetype.clear();
+    rng.clear();
+    routes.clear();
+    lod.clear();
+    ticking.clear();
+    dormant.clear();
+    tickDt.clear();
+    phase.clear();
+    active.clear();
+    cues.clear();
+    for (auto* v : {&state, &walking, &alerted, &canSeePlayer, &justTookDamage,
+                    &dead, &stateLocked, &wantsDoor, &thinkDue, &thinkRearm})
+        v->clear();
+    canWalk.clear();
 }
 
-void Enemy::setAnimState(EnemyState s, bool lock = false){
-    if (state == s) return;
+void EnemyStore::init(int i, int entity_) {
+    entity[i] = entity_;
+    state[i] = ENEMY_WALK; // force setAnimState to apply
+    setAnimState(i, ENEMY_IDLE, false);
+}
 
-    state = s;
-    stateLocked = lock;
-    frameIndex = 0;
-    currentFrame = Animations[state][0];
-    fracTime = 0.0f;
+void EnemyStore::reset(int i, float x, float y) {
+    posX[i] = x;
+    posY[i] = y;
+    state[i] = ENEMY_IDLE;
+    alerted[i] = false;
+    dead[i] = false;
+    health[i] = statsOf(i).maxHealth;
+    stateLocked[i] = false;
+    rng[i] = seedFor(i);
+    routes[i].clear();
+    tickDt[i] = 0.0f;
+    thinkDue[i] = 0;   // the game re-arms the first think
+    thinkRearm[i] = 0;
+    spreadPhase(i);
 }
 
-void Enemy::init(int spriteID_){
-    spriteID = spriteID_;
-    addFrames({
-        {ENEMY_IDLE, {0}},
-        {ENEMY_WALK, {1, 2, 3, 4}},
-        {ENEMY_SHOOT, {5, 6, 7}},
-        {ENEMY_PAIN, {8, 9}},
-        {ENEMY_DEAD, {10, 11, 12, 13}}
-});
-    setAnimState(ENEMY_IDLE, false);
+void EnemyStore::reseed(uint64_t s) {
+    seed = s;
+    for (int i = 0; i < size(); i++)
+        rng[i] = seedFor(i);
 }
 
-void Enemy::updateDirnNumWrt(const std::pair<float, float>& pos) {
-    // Vector from enemy to target
-    float dx = pos.first  - position.first;
-    float dy = pos.second - position.second;
+// Offsets so enemies neither tick nor think on the same frames
+void EnemyStore::spreadPhase(int i) {
+    phase[i] = static_cast<uint16_t>(i * 7919u);
+}
 
-    // Angle to target (world space)
-    float targetAngle = std::atan2(-dy, dx);
+// Seconds to an enemy's first think, staggered like its tick phase
+float EnemyStore::firstThinkDelay(int i) const {
+    float f = std::fmod(i * 0.6180339887f, 1.0f); // golden ratio sequence
+    return (1.0f - f) * statsOf(i).thinkInterval;
+}
 
-    // Relative angle w.r.t enemy facing direction
-    float relAngle = normalizeAngle(targetAngle - angle);
+// Pick each enemy's LOD tier and whether it runs this frame. Skipped
+// frames are banked in tickDt and spent on the next tick, so timers
+// and walking keep real-time speed at any tier.
+void EnemyStore::schedule(float deltaTime, const std::pair<float, float>& playerPosition)
+{
+    int n = size();
+    frameCounter++;
+    active.clear();
+    const EnemyLodSettings& s = lodSettings;
+    for (int i = 0; i < n; i++) {
+        ticking[i] = 0;
+        if (dead[i] || dormant[i]) continue; // dormant: time stands still
+        tickDt[i] += deltaTime;
+
+        float dx = posX[i] - playerPosition.first;
+        float dy = posY[i] - playerPosition.second;
+        float d2 = dx*dx + dy*dy;
+        if (canSeePlayer[i] || d2 <= s.nearDist * s.nearDist)
+            lod[i] = LOD_NEAR;
+        else if (d2 <= s.midDist * s.midDist || alerted[i])
+            lod[i] = LOD_MID;
+        else
+            lod[i] = LOD_FAR;
+
+        unsigned period = lod[i] == LOD_NEAR ? 1
+                        : lod[i] == LOD_MID  ? s.midPeriod : s.farPeriod;
+        if ((frameCounter + phase[i]) % period == 0) {
+            ticking[i] = 1;
+            active.push_back(i);
+        }
+    }
+}
 
+// askGameToMove for the enemies ticking this frame: where each would
+// be after its banked time
+void EnemyStore::proposeMoves(std::vector<float>& outX, std::vector<float>& outY) const
+{
+    int n = size();
+    outX.resize(n);
+    outY.resize(n);
+    for (int i : active) {
+        float step = statsOf(i).moveSpeed * tickDt[i];
+        outX[i] = posX[i] + step * std::cos(angle[i]);
+        outY[i] = posY[i] - step * std::sin(angle[i]);
+    }
+}
+
+// updateDirnNumWrt for one enemy: sprite direction seen from (px, py)
+void EnemyStore::updateDirection(int i, float px, float py) {
     // Each sector is pi/4 wide
     const float sectorSize = M_PI / 4.0f;
 
+    // Angle to target (world space)
+    float targetAngle = std::atan2(-(py - posY[i]), px - posX[i]);
+
+    // Relative angle w.r.t enemy facing direction
+    float relAngle = normalizeAngle(targetAngle - angle[i]);
+
     // Shift by pi/8 so that sector 0 is centered at 0
     int dir = static_cast<int>(
         std::floor((relAngle + M_PI / 8.0f) / sectorSize)
@@ -157,208 +314,355 @@ void Enemy::updateDirnNumWrt(const std::pair<float, float>& pos) {
 
     // Wrap to [0, 7]
     if (dir < 0) dir += 8;
-    dir %= 8;
-    //std::cout<<relAngle*180/M_PI<<" : "<<dir<<std::endl;
-    directionNum = dir; 
+    dirNum[i] = dir % 8;
 }
 
-int Enemy::get_current_frame() const{
-    return currentFrame;
+void EnemyStore::updateDirections(float px, float py) {
+    int n = size();
+    for (int i = 0; i < n; i++)
+        if (!dead[i]) updateDirection(i, px, py);
 }
 
-int Enemy::get_dirn_num() const{
-    return directionNum;
+void EnemyStore::process(const std::pair<float, float>& playerPosition, float playerAngle)
+{
+    cues.resize(size());
+
+    // Only this frame's ticking enemies: cost is bounded by the LOD
+    // tiers, not by how many enemies the level holds
+    JobSystem::parallelFor((int)active.size(), 32, [&](int begin, int end) {
+        for (int k = begin; k < end; k++) {
+            int i = active[k];
+            processOne(i, tickDt[i], playerPosition, playerAngle);
+            tickDt[i] = 0.0f;
+        }
+    });
+
+    // Serial resolve, index order: same output for any thread count
+    for (int i : active) {
+        for (int c = 0; c < cues[i].count; c++) {
+            const EnemyCue& cue = cues[i].cue[c];
+            AudioManager::playSpatialSFX(*cue.name, cue.distance, cue.relativeAngle);
+        }
+        cues[i].count = 0;
+        if (damageThisFrame[i] > 0 && logEvents)
+            std::cout << "Enemy giving damage " << damageThisFrame[i] << "\n";
+    }
 }
 
-void Enemy::moveNextFrame() {
-    auto &frames = Animations[state];
-    if (frames.empty()) return;
+// Timers, thinking, animation and walking for enemy i. Touches nothing
+// outside column i, so it is safe to run for many enemies at once.
+void EnemyStore::processOne(int i, float deltaTime,
+    const std::pair<float, float>& playerPosition, float playerAngle)
+{
+    cues[i].count = 0;
+    if (dead[i]) return;
+    updateDirection(i, playerPosition.first, playerPosition.second);
+
+    // Think when the wake-up has fired; a locked animation (pain,
+    // shooting, a chase leg) holds it until the animation ends
+    if (thinkDue[i] && !stateLocked[i]) {
+        thinkDue[i] = 0;
+        thinkRearm[i] = 1;
+        think(i, playerPosition, playerAngle);
+    }
 
-    frameIndex = (frameIndex + 1) % frames.size();
-    currentFrame = frames[frameIndex];
+    // Animation frames, only while the player can see us
+    const EnemyArchetype& at = archetypes[archetype[i]];
+    if (!canSeePlayer[i]) {
+        finishAnimation(i);
+    }
+    else if (state[i] == ENEMY_IDLE) {
+        fracTime[i] = 0.0f;
+        frameIndex[i] = 0;
+        currentFrame[i] = at.animations[ENEMY_IDLE][0];
+    }
+    else {
+        const auto& frames = at.animations[state[i]];
+        float duration = at.stats.DurationPerSprite;
+        fracTime[i] += deltaTime;
+        while (fracTime[i] > duration) {
+            moveNextFrame(i);
+            fracTime[i] -= duration;
+            if (frameIndex[i] == (int)frames.size() - 1) {
+                if (state[i] == ENEMY_DEAD) {
+                    dead[i] = true;
+                    stateLocked[i] = true;
+                    break;
+                }
+                if (!walking[i]) {   // Pain or shooting end
+                    stateLocked[i] = false;
+                    thinkDue[i] = 0;     // next think a full interval on
+                    thinkRearm[i] = 1;
+                    fracTime[i] = 0.0f;
+                    if (state[i] == ENEMY_SHOOT)
+                        damageThisFrame[i] = rollEnemyDamage(i);
+                }
+            }
+        }
+    }
+
+    // Walking
+    if (dead[i] || !walking[i]) return;
+    float step = at.stats.moveSpeed * deltaTime;
+    float dx = destX[i] - posX[i];
+    float dy = destY[i] - posY[i];
+
+    if (dx*dx + dy*dy <= step*step) {
+        posX[i] = destX[i];
+        posY[i] = destY[i];
+        walking[i] = false;
+        setAnimState(i, ENEMY_IDLE, false);
+        stateLocked[i] = false;
+    } else if (canWalk[i] > 0) {
+        posX[i] += step * std::cos(angle[i]);
+        posY[i] -= step * std::sin(angle[i]);
+    } else {
+        if (canWalk[i] < 0 && canOpenDoor(i))
+            wantsDoor[i] = true;
+
+        destX[i] = posX[i]; // cancel walk
+        destY[i] = posY[i];
+        walking[i] = false;
+        setAnimState(i, ENEMY_IDLE, false);
+        stateLocked[i] = false;
+    }
 }
 
-float Enemy::get_size() const{
-    return sze;
+void EnemyStore::emitCue(int i, const std::string& name, float dist, float relAngle) {
+    EnemyCues& c = cues[i];
+    if (c.count < 2)
+        c.cue[c.count++] = {&name, dist, relAngle};
 }
 
-void Enemy::walkTo(float x, float y){ // for testing purposes
-    destinationOfWalk = std::make_pair(x, y);
+void EnemyStore::setAnimState(int i, EnemyState s, bool lock){
+    if (state[i] == s) return;
 
-    float dx = x - position.first;
-    float dy = y - position.second;
+    state[i] = s;
+    stateLocked[i] = lock;
+    frameIndex[i] = 0;
+    currentFrame[i] = archetypes[archetype[i]].animations[s][0];
+    fracTime[i] = 0.0f;
+}
 
-    float baseAngle = std::atan2(-dy, dx);
+// Unseen enemies don't step frames: one-shot animations (pain, shoot,
+// death) complete at once with their usual end effects, loops hold
+void EnemyStore::finishAnimation(int i) {
+    if (state[i] != ENEMY_DEAD && (walking[i] || !stateLocked[i]))
+        return;
+    const auto& frames = archetypes[archetype[i]].animations[state[i]];
+    frameIndex[i] = (int)frames.size() - 1;
+    currentFrame[i] = frames[frameIndex[i]];
+    fracTime[i] = 0.0f;
+    if (state[i] == ENEMY_DEAD) {
+        dead[i] = true;
+        stateLocked[i] = true;
+        return;
+    }
+    stateLocked[i] = false;
+    thinkDue[i] = 0;
+    thinkRearm[i] = 1;
+    if (state[i] == ENEMY_SHOOT)
+        damageThisFrame[i] = rollEnemyDamage(i);
+}
+
+void EnemyStore::moveNextFrame(int i) {
+    const auto& frames = archetypes[archetype[i]].animations[state[i]];
+    if (frames.empty()) return;
+
+    frameIndex[i] = (frameIndex[i] + 1) % frames.size();
+    currentFrame[i] = frames[frameIndex[i]];
+}
 
-    angle = baseAngle ;
+void EnemyStore::walkTo(int i, float x, float y){ // for testing purposes
+    destX[i] = x;
+    destY[i] = y;
+    angle[i] = std::atan2(-(y - posY[i]), x - posX[i]);
 
-    setAnimState(ENEMY_WALK);
-    walking = true;
+    setAnimState(i, ENEMY_WALK);
+    walking[i] = true;
 }
 
-void Enemy::think(const std::pair<float, float>& playerPosition, float playerAngle){
-    if(stateLocked)
+void EnemyStore::think(int i, const std::pair<float, float>& playerPosition, float playerAngle){
+    if(stateLocked[i])
         return;
-    //std::cout << "current state: "<< state << "\n";
-    if(health <= 0 && !isDead){
-        setAnimState(ENEMY_DEAD, true);
-        AudioManager::playSpatialSFX(
-            rand() % 2 == 0 ? "enemy_die1" : "enemy_die2", 
-            std::hypot(
-                playerPosition.first  - position.first,
-                playerPosition.second - position.second
-            ),
-            atan2(
-                position.second - playerPosition.second,
-                position.first  - playerPosition.first
-            ) - playerAngle
+    const EnemyArchetype& at = archetypes[archetype[i]];
+    const EnemyStats& stats = at.stats;
+    float x = posX[i], y = posY[i];
+    float dist = std::hypot(
+            playerPosition.first  - x,
+            playerPosition.second - y
         );
+    float relAngle = atan2(
+            y - playerPosition.second,
+            x - playerPosition.first
+        ) - playerAngle;
+
+    if(health[i] <= 0 && !dead[i]){
+        setAnimState(i, ENEMY_DEAD, true);
+        if(!at.deathSFX.empty())
+            emitCue(i, at.deathSFX[rng[i].range(at.deathSFX.size())],
+                dist, relAngle);
         return;
     }
-    if(justTookDamage && canEnterPain()){
-        setAnimState(ENEMY_PAIN, true);
-        justTookDamage = false;
-        AudioManager::playSpatialSFX("enemy_pain", 
-            std::hypot(
-                playerPosition.first  - position.first,
-                playerPosition.second - position.second
-            ),
-            atan2(
-                position.second - playerPosition.second,
-                position.first  - playerPosition.first
-            ) - playerAngle
-        );
+    if(justTookDamage[i] && canEnterPain(i)){
+        setAnimState(i, ENEMY_PAIN, true);
+        justTookDamage[i] = false;
+        emitCue(i, at.painSFX, dist, relAngle);
         return;
     }
-    else if(justTookDamage){
-        justTookDamage = false;
+    else if(justTookDamage[i]){
+        justTookDamage[i] = false;
     }
-    float dist = std::hypot(
-            playerPosition.first  - position.first,
-            playerPosition.second - position.second
-        );
     bool inAttackRange = (
-        dist <= attackRange
+        dist <= stats.attackRange
     );
-    if (canSeePlayer) {
-        if(!alerted)
-        AudioManager::playSpatialSFX("enemy_alert", 
-            dist,
-            atan2(
-                position.second - playerPosition.second,
-                position.first  - playerPosition.first
-            ) - playerAngle
-        );
-        alerted = true; // Seen player once -> Alerted
-        
+    if (canSeePlayer[i]) {
+        if(!alerted[i])
+            emitCue(i, at.alertSFX, dist, relAngle);
+        alerted[i] = true; // Seen player once -> Alerted
     }
-    int chanceDivisor = computeEnemyHitChance(dist);
-    if(canSeePlayer && inAttackRange && randomAttackChance(chanceDivisor)){
-        setAnimState(ENEMY_SHOOT, true);
-        AudioManager::playSpatialSFX("enemy_shoot", 
-            dist,
-            atan2(
-                position.second - playerPosition.second,
-                position.first  - playerPosition.first
-            ) - playerAngle
-        );
+    int chanceDivisor = computeEnemyHitChance(stats, dist);
+    if(canSeePlayer[i] && inAttackRange && randomAttackChance(i, chanceDivisor)){
+        setAnimState(i, ENEMY_SHOOT, true);
+        emitCue(i, at.shootSFX, dist, relAngle);
         return;
     }
-    if(canSeePlayer || alerted){
-        if(alerted) std::cout<< position.first<<", "<<position.second<<" is alerted.\n";
-        if(!walking){
-            // Vector to target
-            float dx = playerPosition.first - position.first;
-            float dy = playerPosition.second - position.second;
-            float dist = std::hypot(dx, dy);
-
+    if(canSeePlayer[i] || alerted[i]){
+        if(!walking[i]){
             if (dist < 3.0f)
                 return;
 
-            // Normalize
-            float nx = dx / dist;
-            float ny = dy / dist;
+            float tx, ty;
+            if (chaseStep(i, (int)std::floor(playerPosition.first),
+                    (int)std::floor(playerPosition.second), tx, ty)) {
+                // Follow the flow field (or a room route) around walls
+                destX[i] = tx;
+                destY[i] = ty;
+            }
+            else {
+                // No path known: straight at the player
+                float nx = (playerPosition.first - x) / dist;
+                float ny = (playerPosition.second - y) / dist;
 
-            // Random angular error
-            float r = static_cast<float>(rand()) / RAND_MAX; // [0,1]
-            float error = (r * 2.0f - 1.0f) * walk_angle_error;
+                // Random angular error
+                float r = rng[i].unit(); // [0,1]
+                float error = (r * 2.0f - 1.0f) * stats.walk_angle_error;
 
-            float baseAngle = std::atan2(-ny, nx);
-            float finalAngle = baseAngle + error;
+                float baseAngle = std::atan2(-ny, nx);
+                float finalAngle = baseAngle + error;
 
-            // Choose how far to walk this segment
-            float walkDist = std::min(dist, walk_segment_length); 
-            
-            // Compute deviated destination
-            destinationOfWalk.first  = position.first  + walkDist * std::cos(finalAngle);
-            destinationOfWalk.second = position.second - walkDist * std::sin(finalAngle);
+                // Choose how far to walk this segment
+                float walkDist = std::min(dist, stats.walk_segment_length);
 
-            angle = std::atan2(
-                -(destinationOfWalk.second - position.second),
-                (destinationOfWalk.first  - position.first)
-            );
+                // Compute deviated destination
+                destX[i] = x + walkDist * std::cos(finalAngle);
+                destY[i] = y - walkDist * std::sin(finalAngle);
+            }
+
+            angle[i] = std::atan2(-(destY[i] - y), destX[i] - x);
 
-            setAnimState(ENEMY_WALK, true);
-            walking = true;
+            setAnimState(i, ENEMY_WALK, true);
+            walking[i] = true;
         }
         return;
     }
     else{
-        setAnimState(ENEMY_IDLE, false);
+        setAnimState(i, ENEMY_IDLE, false);
     }
 }
 
-void Enemy::updateCanSeePlayer(bool x){
-    canSeePlayer = x;
-}
-bool Enemy::takeDamage(int dmg){
-    if(!stateLocked)
-        justTookDamage = true;
-    int beforeDMGHealth = health;
-    health -= dmg;
-    std::cout << "Enemy took " << dmg << " damage, health now " << health << std::endl;
-    if(health < 0) health = 0;
-    return health==0 && beforeDMGHealth > 0;
+// Next chase destination: the centre of our own tile if we are
+// off-centre (so the box clears corners), otherwise a straight run of
+// up to walk_segment_length tiles down the flow field. Past the field's
+// radius, follow a route planned on the room graph instead.
+bool EnemyStore::chaseStep(int i, int goalX, int goalY, float& tx, float& ty) {
+    int x = (int)std::floor(posX[i]);
+    int y = (int)std::floor(posY[i]);
+    int nx, ny;
+    bool inField = chaseField && chaseField->nextStep(x, y, nx, ny);
+    if (inField)
+        routes[i].clear();
+    else if (!routeStep(i, x, y, goalX, goalY, nx, ny))
+        return false;
+
+    float cx = x + 0.5f, cy = y + 0.5f;
+    if (std::fabs(posX[i] - cx) > 0.1f || std::fabs(posY[i] - cy) > 0.1f) {
+        tx = cx;
+        ty = cy;
+        return true;
+    }
+
+    int stepX = nx - x, stepY = ny - y;
+    int maxSteps = inField ? std::max(1, (int)statsOf(i).walk_segment_length) : 1;
+    for (int s = 1; s < maxSteps; s++) {
+        int fx, fy;
+        if (!chaseField->nextStep(nx, ny, fx, fy) ||
+            fx - nx != stepX || fy - ny != stepY)
+            break;
+        nx = fx;
+        ny = fy;
+    }
+    tx = nx + 0.5f;
+    ty = ny + 0.5f;
+    return true;
 }
 
-bool Enemy::canEnterPain(){
-    if(rand() % painChanceDivisor == 0)
+bool EnemyStore::routeStep(int i, int x, int y, int goalX, int goalY,
+    int& nx, int& ny)
+{
+    if (!routeGraph) return false;
+    PathRoute& route = routes[i];
+    // Replan when finished or when the goal has moved off by a room
+    if (route.done() ||
+        std::abs(route.goalX - goalX) + std::abs(route.goalY - goalY) > 8) {
+        if (!routeGraph->plan(x, y, goalX, goalY, route)) return false;
+    }
+    if (routeGraph->nextStep(x, y, route, nx, ny))
         return true;
-    return false;
+    // Knocked off the route (door, collision): one fresh try
+    return routeGraph->plan(x, y, goalX, goalY, route) &&
+           routeGraph->nextStep(x, y, route, nx, ny);
 }
 
-bool Enemy::randomAttackChance(int chanceDivisor){
-    if(rand() % chanceDivisor == 0)
-        return true;
-    return false;
+bool EnemyStore::takeDamage(int i, int dmg){
+    if(!stateLocked[i])
+        justTookDamage[i] = true;
+    int beforeDMGHealth = health[i];
+    health[i] -= dmg;
+    if (logEvents)
+        std::cout << "Enemy took " << dmg << " damage, health now " << health[i] << "\n";
+    if(health[i] < 0) health[i] = 0;
+    return health[i]==0 && beforeDMGHealth > 0;
 }
-int Enemy::computeEnemyHitChance(float dist) {
+
+bool EnemyStore::canEnterPain(int i){
+    return rng[i].range(statsOf(i).painChanceDivisor) == 0;
+}
+
+bool EnemyStore::randomAttackChance(int i, int chanceDivisor){
+    if (chanceDivisor <= 0) return false; // out of range
+    return rng[i].range(chanceDivisor) == 0;
+}
+int EnemyStore::computeEnemyHitChance(const EnemyStats& stats, float dist) {
     const float MIN_DIST = 1.5f;
-    const float MAX_DIST = attackRange + 1.0f;
+    const float MAX_DIST = stats.attackRange + 1.0f;
 
     dist = std::clamp(dist, MIN_DIST, MAX_DIST);
     float t = (dist - MIN_DIST) / (MAX_DIST - MIN_DIST);
 
     // Quadratic falloff (feels very Wolf-like)
-    return (int) attackChanceDivisor * (1.0f - t * t);
-}
-int Enemy::rollEnemyDamage() {
-    return baseDamage + (rand() % damageSpread) - (damageSpread / 2);
+    return (int) stats.attackChanceDivisor * (1.0f - t * t);
 }
-void Enemy::alert(){
-    alerted = true;
-    std::cout << "Enemy alerted!\n";
+int EnemyStore::rollEnemyDamage(int i) {
+    const EnemyStats& stats = statsOf(i);
+    return stats.baseDamage + rng[i].range(stats.damageSpread) - (stats.damageSpread / 2);
 }
-void Enemy::cancelWalkThisFrame(bool door){
-    if(door)
-        canWalkThisFrame = -1;
-    else 
-        canWalkThisFrame = 0;
+void EnemyStore::alert(int i){
+    alerted[i] = true;
+    if (logEvents)
+        std::cout << "Enemy alerted!\n";
 }
-bool Enemy::canOpenDoor()
+bool EnemyStore::canOpenDoor(int i)
 {
-    return (rand() % doorOpenChanceDivisor == 0);
+    return (rng[i].range(statsOf(i).doorOpenChanceDivisor) == 0);
 }
-void Enemy::openDoor(){
-    wantToOpenThisFrame = true;
-}
\ No newline at end of file
@@ -4,6 +4,10 @@
 #include <utility>
 #include <vector>
 #include <cmath>
+#include <cstdint>
+#include "Random.hpp"
+#include "FlowField.hpp"
+#include "PathGraph.hpp"
 #define PI 3.1415926535f
 // HERE ANGLES ARE TAKEN POSITIVE ANTI-CLOCKWISE FROM TOP CONTRARY TO THE PLAYER
 enum EnemyState {
@@ -11,7 +15,8 @@ enum EnemyState {
     ENEMY_WALK,
     ENEMY_SHOOT,
     ENEMY_PAIN,
-    ENEMY_DEAD
+    ENEMY_DEAD,
+    ENEMY_STATE_COUNT
 };
 
 void load_enemy_textures(
@@ -19,85 +24,175 @@ void load_enemy_textures(
     std::map<std::pair<int, int>, std::string>& Textures
 );
 
-class Enemy {
-    EnemyState state; 
-    bool walking = false;
+// Tuning shared by every enemy, kept once instead of per instance
+struct EnemyStats {
     float walk_segment_length = 1.5f;
-    int spriteID;
-
-    // perception & memory
-    bool alerted = false;
-    bool canSeePlayer = false;
-    bool justTookDamage = false;
-    bool isDead = false;
-    bool stateLocked = false;
-    int canWalkThisFrame = 1;
-    int damageThisFrame = 0;
+    int maxHealth = 100;
 
     // combat stats
-    int health = 100;
     int baseDamage = 10, damageSpread = 5;
     int attackChanceDivisor = 2;
-    int accuracyDivisor = 3;   // 1 in 6 chance 
+    int accuracyDivisor = 3;   // 1 in 6 chance
     int painChanceDivisor = 5; // 1 in 4 chance
     float walk_angle_error = 10.0f * M_PI / 180.0f; // ±10 degrees
     float attackRange = 7.0f;
     int doorOpenChanceDivisor = 3; // 1 in 3 chance
 
     // AI timing
-    float thinkTimer = 0.0f;
     float thinkInterval = 0.5f;
 
-    // Door opening
-    bool wantToOpenThisFrame = false;
+    float sze = 0.5f, moveSpeed = 1.0f, DurationPerSprite = 0.25f;
+};
+
+// One enemy type, loaded from config/enemyTypes.txt: tuning, the
+// animation frame table and sound names. Held once per type; enemy
+// instances only store the archetype id.
+struct EnemyArchetype {
+    std::string name = "guard";
+    EnemyStats stats;
+    std::vector<std::vector<int>> animations; // indexed by EnemyState
+    std::string framesFile = "config/enemyFrames.txt"; // <frame> <dirn> <png>
+
+    std::string alertSFX = "enemy_alert";
+    std::string painSFX  = "enemy_pain";
+    std::string shootSFX = "enemy_shoot";
+    std::vector<std::string> deathSFX = {"enemy_die1", "enemy_die2"};
+
+    EnemyArchetype();
+};
+
+// AI level of detail: how often an enemy is processed
+enum EnemyLod : uint8_t {
+    LOD_NEAR,   // visible or close: every frame
+    LOD_MID,    // every midPeriod frames
+    LOD_FAR     // every farPeriod frames
+};
+
+struct EnemyLodSettings {
+    float nearDist = 12.0f, midDist = 32.0f; // tiles
+    int midPeriod = 4, farPeriod = 16;       // frames
+};
+
+// A sound an enemy asked for during the parallel pass, played afterwards
+struct EnemyCue {
+    const std::string* name;
+    float distance, relativeAngle;
+};
+struct EnemyCues {
+    int count = 0;
+    EnemyCue cue[2]; // think emits at most alert + shoot
+};
 
-    std::pair<float, float> position, destinationOfWalk;
-    float angle, sze=0.5f, moveSpeed = 1.0f, DurationPerSprite = 0.25f, fracTime = 0.0f;
-    int currentFrame = 0, frameIndex = 0, directionNum;
-    std::map<EnemyState, std::vector<int>> Animations;
+// Structure-of-arrays enemy storage: enemy i is column i of every
+// array below, and per-frame work runs as batch passes over them.
+// Flags are bytes (not vector<bool>) so passes can write them freely.
+class EnemyStore {
 public:
-    Enemy(float x, float y, float theta);
-    std::pair<float, float> get_position() const;
-    float get_size() const;
-    float get_angle() const;
-    void _process(float deltaTime, const std::pair<float, float>& pos, float playerAngle);
-    void addFrame(EnemyState s, int frame);
-    void addFrames(const std::map<EnemyState, std::vector<int>>& Anim);
-    void setAnimState(EnemyState s, bool );
-    void init(int spriteID_);
-    void updateDirnNumWrt(const std::pair<float, float>& pos);
-    int get_current_frame() const;
-    int get_dirn_num() const;
-    void moveNextFrame();
-    void walkTo(float x, float y);
-    void alert();
-    bool canEnterPain();
-    bool randomAttackChance(int);
-    void think(const std::pair<float, float>& pos, float playerAngle);
-    void updateCanSeePlayer(bool);
-    bool takeDamage(int);
-    int computeEnemyHitChance(float dist);
-    int rollEnemyDamage();
-    int getDamageThisFrame() const { return damageThisFrame; }
-    void clearDamageThisFrame() { damageThisFrame = 0; }
-    bool isAlerted() const { return alerted; }
-    int get_spriteID() const { return spriteID; }
-    std::pair<float, float> askGameToMove(float deltaTime);
-    void cancelWalkThisFrame(bool door);
-    void allowWalkNextFrame() { canWalkThisFrame = 1; }
-    bool get_isDead() const { return isDead; }
-    bool canOpenDoor();
-    void openDoor();
-    bool get_wantToOpenDoor() const { return wantToOpenThisFrame; }
-    std::pair<int, int> nearbyDoor();
-    void reset_wantToOpenThisFrame() { wantToOpenThisFrame = false; }
-    void reset(){
-        state = ENEMY_IDLE;
-        alerted = false;
-        isDead = false;
-        health = 100;
-        thinkTimer = 0.0f;
-        stateLocked = false;
-    }
-    void setPosition(std::pair<float, float> x){position=x;}
+    // position & movement (hot)
+    std::vector<float> posX, posY, angle;
+    std::vector<float> destX, destY;
+    std::vector<int8_t> canWalk;       // 1 free, 0 blocked, -1 door
+    std::vector<int> doorX, doorY;     // door that blocked the last move
+
+    // state & timers (hot)
+    std::vector<uint8_t> state;        // EnemyState
+    std::vector<float> fracTime;       // into the current animation frame
+    // Thinking is woken by the game's timer wheel: thinkDue is set when
+    // the wake-up fires, thinkRearm asks for the next one a full
+    // interval out (resolved serially, the wheel is not thread safe)
+    std::vector<uint8_t> thinkDue, thinkRearm;
+    std::vector<int> health;
+    std::vector<int> frameIndex, currentFrame, dirNum;
+    std::vector<int> damageThisFrame;
+
+    // perception & memory
+    std::vector<uint8_t> walking, alerted, canSeePlayer, justTookDamage;
+    std::vector<uint8_t> dead, stateLocked, wantsDoor;
+
+    // cold
+    std::vector<int> entity;           // the game's world entity (drawing)
+    std::vector<uint16_t> archetype;   // index into archetypes
+    std::vector<Random> rng;           // per-enemy, order independent
+    std::vector<EnemyCues> cues;       // sounds requested this frame
+    std::vector<PathRoute> routes;     // long-range plan, past the flow field
+
+    // LOD scheduling
+    std::vector<uint8_t> lod;          // EnemyLod
+    std::vector<uint8_t> ticking;      // processed this frame?
+    std::vector<float> tickDt;         // time since last processed
+    std::vector<uint16_t> phase;       // spreads ticks over frames
+    std::vector<int> active;           // enemies ticking this frame
+    std::vector<uint8_t> dormant;      // in a room cut off from the player: frozen
+    EnemyLodSettings lodSettings;
+    bool logEvents = true;             // per-enemy lines on stdout; off headless
+
+    // Shared path toward the player, set by Game before process();
+    // read-only while enemies think
+    const FlowField* chaseField = nullptr;
+    const PathGraph* routeGraph = nullptr; // far targets, rooms and doors
+
+    // Registry of enemy types (built-in guard until a config is loaded)
+    std::vector<EnemyArchetype> archetypes;
+    bool loadArchetypes(const std::string& filePath);
+    int findArchetype(const std::string& name) const;
+
+    // Per-enemy streams derive from this; reseed before a run starts
+    uint64_t seed = 0x5EEDull;
+    void reseed(uint64_t s);
+    const EnemyStats& statsOf(int i) const { return archetypes[archetype[i]].stats; }
+
+    EnemyStore();
+    int size() const { return static_cast<int>(posX.size()); }
+    int add(float x, float y, float theta, int type = 0);
+    void clear();
+    void init(int i, int entity_);
+    void reset(int i, float x, float y);
+    float firstThinkDelay(int i) const;
+
+    // Batch passes. process() runs enemies in parallel: each one only
+    // writes its own column, and shared effects (sounds, damage, door
+    // requests) are left as per-enemy intents resolved in index order.
+    void schedule(float deltaTime, const std::pair<float, float>& playerPosition);
+    void proposeMoves(std::vector<float>& outX, std::vector<float>& outY) const;
+    void updateDirections(float px, float py);
+    void process(const std::pair<float, float>& playerPosition, float playerAngle);
+    void processOne(int i, float deltaTime,
+        const std::pair<float, float>& playerPosition, float playerAngle);
+
+    // Per enemy
+    std::pair<float, float> get_position(int i) const { return {posX[i], posY[i]}; }
+    float get_size(int i) const { return statsOf(i).sze; }
+    int get_current_frame(int i) const { return currentFrame[i]; }
+    int get_dirn_num(int i) const { return dirNum[i]; }
+    int get_entity(int i) const { return entity[i]; }
+    bool get_isDead(int i) const { return dead[i]; }
+    bool isAlerted(int i) const { return alerted[i]; }
+    bool get_wantToOpenDoor(int i) const { return wantsDoor[i]; }
+    void reset_wantToOpenThisFrame(int i) { wantsDoor[i] = 0; }
+    int getDamageThisFrame(int i) const { return damageThisFrame[i]; }
+    void clearDamageThisFrame(int i) { damageThisFrame[i] = 0; }
+    void updateCanSeePlayer(int i, bool x) { canSeePlayer[i] = x; }
+    void allowWalkNextFrame(int i) { canWalk[i] = 1; }
+    void cancelWalkThisFrame(int i, bool door) { canWalk[i] = door ? -1 : 0; }
+    void setAnimState(int i, EnemyState s, bool lock = false);
+    void walkTo(int i, float x, float y);
+    void alert(int i);
+    bool takeDamage(int i, int dmg);
+    void think(int i, const std::pair<float, float>& pos, float playerAngle);
+
+private:
+    void moveNextFrame(int i);
+    void finishAnimation(int i);
+    void spreadPhase(int i);
+    void updateDirection(int i, float px, float py);
+    bool chaseStep(int i, int goalX, int goalY, float& tx, float& ty);
+    bool routeStep(int i, int x, int y, int goalX, int goalY, int& nx, int& ny);
+    void emitCue(int i, const std::string& name, float dist, float relAngle);
+    bool canEnterPain(int i);
+    bool randomAttackChance(int i, int chanceDivisor);
+    bool canOpenDoor(int i);
+    int computeEnemyHitChance(const EnemyStats& stats, float dist);
+    int rollEnemyDamage(int i);
+    Random seedFor(int i) const { return Random(seed + 0x10001ull * i); }
+    unsigned frameCounter = 0;
 };
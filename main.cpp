@@ -2,39 +2,177 @@
 #include "AudioManager.hpp"
 #include "UIManager.hpp"
 #include "MenuManager.hpp"
+#include "AssetPack.hpp"
+#include "AssetLoader.hpp"
+#include <fstream>
 #include <iostream>
+#include <random>
+#include <cstdlib>
 #include "path_utils.h"
 
 Game* game = nullptr;
 
 int main(int argc, char* argv[]) {
     std::string base = getExeDir();
+
+    // Demos: --record <file> captures input per tick, --play <file>
+    // replays it (as fast as possible, then exits)
+    // --headless: no window or audio, ticks run back to back; --ticks <n>
+    // stops after n ticks (default: until the demo ends or forever)
+    // --map <file> / --enemies <file>: another level, e.g. from tools/levelgen;
+    // a compiled level (.w3dl) holds its enemies, so --enemies is ignored
+    // --compile <out>: load the level, write it compiled to <out> and exit
+    // --pack <file>: images and sounds from this pack (default assets.pak
+    // next to the game, if there is one), see tools/assetpack
+    std::string recordPath, playPath, compilePath, packPath;
+    std::string level = "config/map.txt", enemyList = "config/enemies.txt";
+    bool headless = false;
+    uint64_t maxTicks = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--headless") headless = true;
+        else if (i + 1 >= argc) break;
+        else if (arg == "--record") recordPath = argv[++i];
+        else if (arg == "--play") playPath = argv[++i];
+        else if (arg == "--ticks") maxTicks = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--map") level = argv[++i];
+        else if (arg == "--enemies") enemyList = argv[++i];
+        else if (arg == "--compile") compilePath = argv[++i];
+        else if (arg == "--pack") packPath = argv[++i];
+    }
+    if (!compilePath.empty())
+        headless = true;
+    // Relative paths are from the game directory, like the config files
+    auto resolve = [&](const std::string& path) {
+        bool absolute = !path.empty() && (path[0] == '/' || path[0] == '\\' ||
+                        (path.size() > 1 && path[1] == ':'));
+        return absolute ? path : base + "/" + path;
+    };
+
     // Initialisation
     game = new Game();
+    game->headless = headless;
+    uint64_t seed = std::random_device{}();
+    if (!playPath.empty()) {
+        if (!game->demo.play(playPath))
+            return 1;
+        if (game->demo.tickRate != Game::tickRate)
+            std::cerr << "Demo was recorded at " << game->demo.tickRate
+                      << " ticks/s, playing at " << Game::tickRate << "\n";
+        level = game->demo.level;
+        if (!game->demo.enemies.empty())
+            enemyList = game->demo.enemies;
+        seed = game->demo.seed;
+    }
+    if (!packPath.empty())
+        AssetPack::open(resolve(packPath));
+    else if (std::ifstream(base + "/assets.pak"))
+        AssetPack::open(base + "/assets.pak");
+
     // Loading Enemies
-    game->loadEnemies(base + "/config/enemies.txt");
+    game->loadEnemyArchetypes(base + "/config/enemyTypes.txt");
+    bool compiled = LevelFile::isCompiled(resolve(level));
+    if (compiled) {
+        if (!game->openCompiledLevel(resolve(level)))
+            return 1;
+    }
+    else
+        game->loadEnemies(resolve(enemyList));
 
     // Initialize Game (player and enemies)
     game->init("ESCAPE", 100, 100, 800, 600, true);
     
-    // Load Map, Textures and Audio
+    // Queue Textures and Audio
     game->loadAllTextures(base + "/config/textureMapping.txt");
-    game->loadEnemyTextures(base + "/config/enemyFrames.txt");
+    game->loadEnemyArchetypeTextures(base);
     game->loadDecorationTextures(base + "/config/Decorations.txt");
     AudioManager::loadAllAudios(base + "/config/audioConfig.txt");
-    UIManager::loadTextures(base + "/config/HUD.txt", game->getRenderer());
-    game->loadMapDataFromFile(base + "/config/map.txt");
+    if (!headless)
+        UIManager::loadTextures(base + "/config/HUD.txt", game->getRenderer());
+
+    // Loading screen: the workers decode, this thread uploads textures
+    // as they arrive and draws the progress bar
+    const int FPS = 60;
+    const float frameDelay = 1000.0f / FPS;
+    game->setState(GameState::LOADING);
+    Uint32 loadStart = SDL_GetTicks();
+    if (headless)
+        AssetLoader::finish();
+    else {
+        AssetLoader::start();
+        while (!AssetLoader::pump((Uint32)frameDelay)) {
+            SDL_Event event;
+            while (SDL_PollEvent(&event))
+                if (event.type == SDL_QUIT)
+                    game->quit();
+            if (!game->running()) {
+                AssetLoader::cancel();
+                delete game;
+                return 0;
+            }
+            MenuManager::renderLoading(game->getRenderer(), {800, 600}, AssetLoader::progress());
+        }
+    }
+    std::cout << "Assets loaded in " << SDL_GetTicks() - loadStart << " ms\n";
+    AssetLoader::report();
+    game->setState(GameState::MAINMENU);
+
+    // Load Map
+    if (compiled)
+        game->loadCompiledMap();
+    else
+        game->loadMapDataFromFile(resolve(level));
+
+    if (!compilePath.empty()) {
+        bool ok = game->compileLevel(compilePath);
+        delete game;
+        return ok ? 0 : 1;
+    }
 
     // Place Player
     game->placePlayerAt(1.5f, 1.5f, 0.0f);
+    game->seedRandom(seed);
+
+    // Demos start straight in gameplay, skipping the main menu
+    if (!recordPath.empty() && !game->demo.playing() &&
+        game->demo.record(recordPath, Game::tickRate, seed, level, enemyList))
+        game->setState(GameState::GAMEPLAY);
+    if (game->demo.playing() || headless)
+        game->setState(GameState::GAMEPLAY);
+
+    if (headless) {
+        // Simulated time is just the tick count: no events, no rendering,
+        // no limiter. A lost or won run restarts unless a demo drives it.
+        Uint32 start = SDL_GetTicks();
+        uint64_t ticks = 0, runs = 1;
+        while (game->running() && (maxTicks == 0 || ticks < maxTicks)) {
+            game->update(Game::tickDt);
+            if (!game->running())
+                break; // demo played out
+            ticks++;
+            if (game->getState() == GameState::GAMEPLAY)
+                continue;
+            if (game->demo.playing())
+                break;
+            game->restart();
+            runs++;
+        }
+        Uint32 ms = SDL_GetTicks() - start;
+        std::cout << "Headless: " << ticks << " ticks, " << runs << " run(s), "
+                  << game->enemyCount() << " enemies, " << ms << " ms ("
+                  << (ms ? ticks * 1000.0 / ms : 0.0) << " ticks/s)\n";
+        delete game;
+        return 0;
+    }
 
     // Start music 
     AudioManager::playMusic("Menu", -1);
 
-    const int FPS = 60;
-    const float frameDelay = 1000.0f / FPS;
-
     Uint32 lastTicks = SDL_GetTicks();
+    // Real time not yet simulated; update() eats it in fixed ticks
+    float accumulator = 0.0f;
+    const float maxFrameTime = 0.25f; // after a hitch, slow down instead of spiralling
+    Uint32 demoStart = lastTicks;
 
     while (game->running()) {
         Uint32 frameStart = SDL_GetTicks();
@@ -49,18 +187,35 @@ int main(int argc, char* argv[]) {
         {
         case GameState::GAMEPLAY:
             game->handleEvents();
-            game->update(deltaTime);
+            if (game->demo.playing()) {
+                // One recorded tick per frame; wins, losses or a pause end it
+                game->update(Game::tickDt);
+                if (game->getState() != GameState::GAMEPLAY)
+                    game->quit();
+                game->render();
+                continue;
+            }
+            accumulator += std::min(deltaTime, maxFrameTime);
+            while (accumulator >= Game::tickDt &&
+                   game->getState() == GameState::GAMEPLAY) {
+                game->update(Game::tickDt);
+                accumulator -= Game::tickDt;
+            }
             game->render();
             break;
         case GameState::RESET:
             game->restart();
             break;
         default:
+            // Blocks until input (or idleWaitMs), so no frame limiter here
+            game->freeMouse();
             if (MenuManager::handleEvents(game->state))
                 game->quit();
             MenuManager::renderMenu(game->getRenderer(), {800, 600});
-            game->freeMouse();
-            break;
+            // Time spent idling in menus must not leak into deltaTime
+            lastTicks = SDL_GetTicks();
+            accumulator = 0.0f;
+            continue;
         }
         
         // Frame Limiter 
@@ -71,6 +226,15 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    if (game->demo.playing()) {
+        Uint32 ms = SDL_GetTicks() - demoStart;
+        uint32_t ticks = game->demo.ticks;
+        std::cout << "Demo played " << ticks << " ticks in " << ms << " ms ("
+                  << (ticks ? (float)ms / ticks : 0.0f) << " ms/tick)\n";
+    }
+    else if (game->demo.recording())
+        std::cout << "Demo recorded: " << game->demo.ticks << " ticks\n";
+
     delete game;
     return 0;
 }
@@ -0,0 +1,86 @@
+#include "Check.hpp"
+#include "AreaGraph.hpp"
+#include <algorithm>
+
+// Three rooms in a row; doors are D (starts shut) and O (starts open)
+static const TestGrid rooms{{
+    "#############",
+    "#...#...#...#",
+    "#...D...O...#",
+    "#...#...#...#",
+    "#############",
+}};
+
+static void buildRooms(AreaGraph& g) {
+    g.build(rooms.width(), rooms.height(),
+        [](int x, int y) { return rooms.at(x, y) == '.'; },
+        [](int x, int y) { return rooms.at(x, y) == 'D' || rooms.at(x, y) == 'O'; },
+        [](int x, int y) { return rooms.at(x, y) == 'O'; });
+}
+
+static bool reaches(const AreaGraph& g, int from, int to) {
+    std::vector<int> out;
+    g.flood(from, out);
+    return std::find(out.begin(), out.end(), to) != out.end();
+}
+
+TEST(areaGraphDoorsSplitAndLinkRooms) {
+    AreaGraph g;
+    buildRooms(g);
+    int left = g.areaAt(1, 1), mid = g.areaAt(5, 1), right = g.areaAt(9, 1);
+    CHECK(g.areaCount() == 3);
+    CHECK(left != mid && mid != right && left != right);
+    CHECK(g.areaAt(0, 0) == -1);
+    CHECK(!reaches(g, left, mid));
+    CHECK(reaches(g, mid, right));
+    g.setDoorOpen(4, 2, true);
+    CHECK(reaches(g, left, right));
+    g.setDoorOpen(8, 2, false);
+    CHECK(!reaches(g, left, right));
+}
+
+TEST(areaGraphSavedFormRoundTrips) {
+    AreaGraph built;
+    buildRooms(built);
+    std::vector<AreaGraph::SavedLink> links;
+    built.save(links);
+    std::vector<int32_t> tiles(built.areaTiles(),
+                               built.areaTiles() + rooms.width() * rooms.height());
+    AreaGraph loaded;
+    CHECK(loaded.load(rooms.width(), rooms.height(), tiles.data(), built.areaCount(),
+                      links.data(), links.size()));
+    CHECK(loaded.areaCount() == 3);
+    CHECK(reaches(loaded, loaded.areaAt(5, 1), loaded.areaAt(9, 1)));
+    CHECK(!reaches(loaded, loaded.areaAt(1, 1), loaded.areaAt(5, 1)));
+}
+
+TEST(areaGraphLoadRejectsBadIndices) {
+    AreaGraph built;
+    buildRooms(built);
+    std::vector<AreaGraph::SavedLink> good;
+    built.save(good);
+    std::vector<int32_t> tiles(built.areaTiles(),
+                               built.areaTiles() + rooms.width() * rooms.height());
+    int w = rooms.width(), h = rooms.height(), n = built.areaCount();
+    AreaGraph g;
+
+    CHECK(!g.load(w, h, tiles.data(), -1, good.data(), good.size()));
+
+    std::vector<int32_t> badTiles = tiles;
+    badTiles[w + 1] = n;
+    CHECK(!g.load(w, h, badTiles.data(), n, good.data(), good.size()));
+    badTiles[w + 1] = -2;
+    CHECK(!g.load(w, h, badTiles.data(), n, good.data(), good.size()));
+
+    std::vector<AreaGraph::SavedLink> bad = good;
+    bad[0].b = n;
+    CHECK(!g.load(w, h, tiles.data(), n, bad.data(), bad.size()));
+    bad = good;
+    bad[0].a = -1;
+    CHECK(!g.load(w, h, tiles.data(), n, bad.data(), bad.size()));
+    bad = good;
+    bad[0].tile = w * h;
+    CHECK(!g.load(w, h, tiles.data(), n, bad.data(), bad.size()));
+
+    CHECK(g.load(w, h, tiles.data(), n, good.data(), good.size()));
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdio>
+#include <vector>
+
+// Minimal harness for the SDL-free modules (make test). TEST(name)
+// registers a case; CHECK records a failure and carries on.
+struct TestCase {
+    const char* name;
+    void (*fn)();
+};
+
+std::vector<TestCase>& testCases();
+int& checkFailures();
+
+struct TestRegistrar {
+    TestRegistrar(const char* name, void (*fn)()) { testCases().push_back({name, fn}); }
+};
+
+#define TEST(name)                                          \
+    static void name();                                     \
+    static TestRegistrar name##Registrar(#name, name);      \
+    static void name()
+
+#define CHECK(cond)                                                      \
+    do {                                                                 \
+        if (!(cond)) {                                                   \
+            std::printf("  %s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            checkFailures()++;                                           \
+        }                                                                \
+    } while (0)
+
+#include <string>
+
+// Map drawn as rows of text: '#' is a wall, anything else is floor
+struct TestGrid {
+    std::vector<std::string> rows;
+    int width() const { return rows.empty() ? 0 : (int)rows[0].size(); }
+    int height() const { return (int)rows.size(); }
+    char at(int x, int y) const {
+        if (x < 0 || y < 0 || x >= width() || y >= height()) return '#';
+        return rows[y][x];
+    }
+    bool wall(int x, int y) const { return at(x, y) == '#'; }
+};
@@ -0,0 +1,94 @@
+#include "Check.hpp"
+#include "Collision.hpp"
+
+static CollisionMap fromGrid(const TestGrid& g) {
+    CollisionMap m;
+    m.build(g.width(), g.height(), [&](int x, int y) { return g.wall(x, y); });
+    return m;
+}
+
+static const TestGrid room{{
+    "########",
+    "#......#",
+    "#......#",
+    "#....#.#",
+    "#......#",
+    "#......#",
+    "#......#",
+    "########",
+}};
+
+TEST(collisionSweepStopsFlushWithReachAhead) {
+    CollisionMap m = fromGrid(room);
+    auto p = m.sweep(3.5f, 1.5f, 0.5f, 0.25f, 10.0f, 0.0f);
+    CHECK(p.first < 6.5f && p.first > 6.49f);   // wall at x = 7
+    CHECK(p.second == 1.5f);
+    p = m.sweep(3.5f, 1.5f, 0.5f, 0.25f, 0.0f, -10.0f);
+    CHECK(p.second >= 1.5f && p.second < 1.51f); // wall at y = 0
+}
+
+TEST(collisionSweepSlidesAlongWalls) {
+    CollisionMap m = fromGrid(room);
+    auto p = m.sweep(2.0f, 1.51f, 0.5f, 0.25f, 0.3f, -0.3f);
+    CHECK(p.first == 2.3f);                       // X is free
+    CHECK(p.second > 1.49f && p.second < 1.52f);  // Y stopped by the wall
+}
+
+TEST(collisionSweepNeverTunnels) {
+    CollisionMap m = fromGrid(room);
+    auto p = m.sweep(1.5f, 3.5f, 0.5f, 0.25f, 100.0f, 0.0f);
+    CHECK(p.first < 4.5f);                       // pillar at x = 5
+}
+
+TEST(collisionSweepKeepsReachAtCorners) {
+    // Pillar tile (5, 3): drifting down-right past its corner used to end
+    // a quarter tile from it on X
+    CollisionMap m = fromGrid(room);
+    float x = 4.52f, y = 2.7f;
+    for (int i = 0; i < 100; i++) {
+        auto p = m.sweep(x, y, 0.5f, 0.25f, 0.005f, 0.05f);
+        x = p.first;
+        y = p.second;
+        bool besidePillar = y + 0.25f > 3.0f && y - 0.25f < 4.0f && x < 5.0f;
+        CHECK(!besidePillar || 5.0f - x >= 0.5f - 1e-3f);
+    }
+}
+
+TEST(collisionOneTileCorridorStaysPassable) {
+    const TestGrid corridor{{
+        "###",
+        "#.#",
+        "#.#",
+        "#.#",
+        "#.#",
+        "###",
+    }};
+    CollisionMap m = fromGrid(corridor);
+    float x = 1.3f, y = 1.6f;
+    for (int i = 0; i < 100; i++) {
+        auto p = m.sweep(x, y, 0.5f, 0.25f, 0.01f, 0.03f);
+        x = p.first;
+        y = p.second;
+    }
+    CHECK(y > 4.4f);
+}
+
+TEST(collisionDoorsFlipBitsAndOffMapIsSolid) {
+    CollisionMap m = fromGrid(room);
+    CHECK(m.solid(-1, 2) && m.solid(8, 2));
+    CHECK(!m.solid(2, 2));
+    m.setSolid(2, 2, true);
+    CHECK(m.solid(2, 2));
+    CHECK(m.blockingTile(2.5f, 2.5f, 0.25f) == 2 * m.mapWidth() + 2);
+    m.setSolid(2, 2, false);
+    CHECK(m.blockingTile(2.5f, 2.5f, 0.25f) == -1);
+    CHECK(m.blockingTile(0.1f, -0.5f, 0.25f) == CollisionMap::offMap);
+}
+
+TEST(collisionLoadChecksTheWordCount) {
+    CollisionMap m = fromGrid(room);
+    CollisionMap copy;
+    CHECK(!copy.load(8, 8, m.words().data(), m.words().size() + 1));
+    CHECK(copy.load(8, 8, m.words().data(), m.words().size()));
+    CHECK(copy.solid(5, 3) && !copy.solid(4, 3));
+}
@@ -0,0 +1,45 @@
+#include "Check.hpp"
+#include "Entities.hpp"
+
+TEST(componentStoreAddFindReplace) {
+    ComponentStore<Position> s;
+    CHECK(!s.has(3));
+    CHECK(s.find(3) == nullptr);
+    s.add(3, Position{1.0f, 2.0f});
+    CHECK(s.has(3));
+    CHECK(s.get(3).y == 2.0f);
+    s.add(3, Position{5.0f, 6.0f});   // replaces
+    CHECK(s.size() == 1);
+    CHECK(s.get(3).x == 5.0f);
+    CHECK(!s.has(-1));
+}
+
+TEST(componentStoreRemoveKeepsItPacked) {
+    ComponentStore<int> s;
+    for (Entity e = 0; e < 5; e++)
+        s.add(e * 10, e);
+    s.remove(10);                     // the last one fills the hole
+    s.remove(10);                     // twice is harmless
+    CHECK(s.size() == 4);
+    CHECK(!s.has(10));
+    for (size_t k = 0; k < s.size(); k++)
+        CHECK(s.get(s.owner(k)) == s[k]);
+    CHECK(s.get(40) == 4);
+    s.remove(40);                     // removing the last slot
+    CHECK(s.size() == 3 && !s.has(40));
+    CHECK(s.get(0) == 0 && s.get(20) == 2 && s.get(30) == 3);
+}
+
+TEST(componentStoreSparseIdsAndClear) {
+    ComponentStore<int> s;
+    s.add(5, 1);
+    s.add(3000000, 2);                // far page, allocated on demand
+    CHECK(s.get(3000000) == 2);
+    CHECK(!s.has(3000001));
+    CHECK(!s.has(2999999));
+    s.clear();
+    CHECK(s.empty());
+    CHECK(!s.has(5) && !s.has(3000000));
+    s.add(5, 7);
+    CHECK(s.get(5) == 7);
+}
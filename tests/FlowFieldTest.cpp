@@ -0,0 +1,54 @@
+#include "Check.hpp"
+#include "FlowField.hpp"
+
+static const TestGrid maze{{
+    "#######",
+    "#.....#",
+    "#####.#",
+    "#.....#",
+    "#######",
+}};
+
+static int enterCost(int x, int y) { return maze.wall(x, y) ? -1 : 1; }
+
+TEST(flowFieldDistancesFollowTheCorridor) {
+    FlowField f;
+    f.compute(1, 1, maze.width(), maze.height(), 100, enterCost);
+    CHECK(f.distance(1, 1) == 0);
+    CHECK(f.distance(5, 1) == 4);
+    CHECK(f.distance(1, 3) == 10);   // around the wall, not through it
+    CHECK(f.distance(0, 0) == -1);   // wall
+    CHECK(f.distance(-1, 2) == -1);  // off the map
+}
+
+TEST(flowFieldNextStepLeadsToTheGoal) {
+    FlowField f;
+    f.compute(1, 1, maze.width(), maze.height(), 100, enterCost);
+    int x = 1, y = 3, steps = 0, nx, ny;
+    while (f.nextStep(x, y, nx, ny) && steps < 50) {
+        CHECK(f.distance(nx, ny) == f.distance(x, y) - 1);
+        x = nx;
+        y = ny;
+        steps++;
+    }
+    CHECK(x == 1 && y == 1);
+    CHECK(steps == 10);
+}
+
+TEST(flowFieldMaxCostBoundsTheSearch) {
+    FlowField f;
+    f.compute(1, 1, maze.width(), maze.height(), 3, enterCost);
+    CHECK(f.distance(4, 1) == 3);
+    CHECK(f.distance(5, 1) == -1);
+    int nx, ny;
+    CHECK(!f.nextStep(1, 3, nx, ny));
+}
+
+TEST(flowFieldRecomputeResetsOldDistances) {
+    FlowField f;
+    f.compute(1, 1, maze.width(), maze.height(), 100, enterCost);
+    f.compute(1, 3, maze.width(), maze.height(), 2, enterCost);
+    CHECK(f.distance(1, 3) == 0);
+    CHECK(f.distance(1, 1) == -1);
+    CHECK(f.goalX() == 1 && f.goalY() == 3);
+}
@@ -0,0 +1,117 @@
+#include "Check.hpp"
+#include "LevelFile.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+
+static std::string tempPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static std::vector<char> readAll(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(in), {});
+}
+
+static void writeAll(const std::string& path, const std::vector<char>& bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), bytes.size());
+}
+
+// A 4 x 3 level with two enemies, written by the real writer
+static const int W = 4, H = 3;
+static std::string writeGoodLevel() {
+    static const uint8_t tiles[W * H] = {1, 1, 1, 1,
+                                         1, 0, 0, 1,
+                                         1, 1, 1, 1};
+    static const LevelEnemy spawns[2] = {{1.5f, 1.5f, 0}, {2.5f, 1.5f, 0}};
+    LevelFile::Writer out(W, H, 1);
+    out.add(LEVEL_TILES, tiles, W * H);
+    out.add(LEVEL_ENEMIES, spawns, 2);
+    std::string path = tempPath("wolf_test_level.w3dl");
+    out.write(path);
+    return path;
+}
+
+// Header fields, as laid out by the writer
+static const size_t versionAt = 4, byteOrderAt = 6, widthAt = 8;
+static const size_t sectionsAt = 24, sectionSize = 24;
+
+static bool opensAfter(const std::function<void(std::vector<char>&)>& damage) {
+    std::vector<char> bytes = readAll(writeGoodLevel());
+    damage(bytes);
+    std::string path = tempPath("wolf_test_bad.w3dl");
+    writeAll(path, bytes);
+    LevelFile level;
+    return level.open(path);
+}
+
+TEST(levelFileRoundTrip) {
+    std::string path = writeGoodLevel();
+    CHECK(LevelFile::isCompiled(path));
+    LevelFile level;
+    CHECK(level.open(path));
+    CHECK(level.width() == W && level.height() == H && level.areaCount() == 1);
+    size_t count = 0;
+    const uint8_t* tiles = level.section<uint8_t>(LEVEL_TILES, count);
+    CHECK(tiles && count == W * H && tiles[5] == 0 && tiles[4] == 1);
+    const LevelEnemy* spawns = level.section<LevelEnemy>(LEVEL_ENEMIES, count);
+    CHECK(spawns && count == 2 && spawns[1].x == 2.5f);
+    CHECK(!level.section<LevelDoor>(LEVEL_DOORS, count) && count == 0);
+    CHECK(!level.section<uint32_t>(LEVEL_TILES, count)); // wrong element size
+}
+
+TEST(levelFileRejectsMissingAndEmptyFiles) {
+    LevelFile level;
+    CHECK(!level.open(tempPath("wolf_test_missing.w3dl")));
+    std::string empty = tempPath("wolf_test_empty.w3dl");
+    writeAll(empty, {});
+    CHECK(!level.open(empty));
+    CHECK(!LevelFile::isCompiled(empty));
+    CHECK(!level.isOpen());
+}
+
+TEST(levelFileRejectsTruncatedFiles) {
+    CHECK(!opensAfter([](std::vector<char>& b) { b.resize(10); }));           // inside the header
+    CHECK(!opensAfter([](std::vector<char>& b) { b.resize(sectionsAt + 8); }));
+    CHECK(!opensAfter([](std::vector<char>& b) { b.resize(b.size() - 8); }));  // last section cut
+}
+
+TEST(levelFileRejectsCorruptHeaders) {
+    CHECK(opensAfter([](std::vector<char>&) {}));
+    CHECK(!opensAfter([](std::vector<char>& b) { b[0] = 'X'; }));
+    CHECK(!opensAfter([](std::vector<char>& b) { b[versionAt] ^= 0x7f; }));
+    CHECK(!opensAfter([](std::vector<char>& b) { std::swap(b[byteOrderAt], b[byteOrderAt + 1]); }));
+    CHECK(!opensAfter([](std::vector<char>& b) {
+        int32_t zero = 0;
+        std::memcpy(&b[widthAt], &zero, 4);
+    }));
+}
+
+TEST(levelFileRejectsBadSectionTables) {
+    auto entry = [](std::vector<char>& b, LevelSection s) {
+        return &b[sectionsAt + s * sectionSize];
+    };
+    CHECK(!opensAfter([&](std::vector<char>& b) {          // misaligned
+        uint64_t offset;
+        std::memcpy(&offset, entry(b, LEVEL_ENEMIES), 8);
+        offset += 1;
+        std::memcpy(entry(b, LEVEL_ENEMIES), &offset, 8);
+    }));
+    CHECK(!opensAfter([&](std::vector<char>& b) {          // count past the end
+        uint64_t count = 1ull << 40;
+        std::memcpy(entry(b, LEVEL_ENEMIES) + 8, &count, 8);
+    }));
+    CHECK(!opensAfter([&](std::vector<char>& b) {          // zero element size
+        uint32_t size = 0;
+        std::memcpy(entry(b, LEVEL_ENEMIES) + 16, &size, 4);
+    }));
+    CHECK(!opensAfter([&](std::vector<char>& b) {          // grid smaller than the map
+        uint64_t count = W * H - 1;
+        std::memcpy(entry(b, LEVEL_TILES) + 8, &count, 8);
+    }));
+    CHECK(!opensAfter([&](std::vector<char>& b) {          // no grid at all
+        std::memset(entry(b, LEVEL_TILES), 0, sectionSize);
+    }));
+}
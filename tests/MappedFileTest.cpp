@@ -0,0 +1,29 @@
+#include "Check.hpp"
+#include "MappedFile.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+TEST(mappedFileSeesTheBytes) {
+    std::string path = (std::filesystem::temp_directory_path() / "wolf_test_mapped.bin").string();
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << "packed bytes";
+    }
+    MappedFile f;
+    CHECK(f.open(path));
+    CHECK(f.isOpen() && f.size() == 12);
+    CHECK(std::memcmp(f.data(), "packed bytes", 12) == 0);
+    f.close();
+    CHECK(!f.isOpen() && f.size() == 0 && f.data() == nullptr);
+}
+
+TEST(mappedFileRejectsMissingAndEmptyFiles) {
+    auto dir = std::filesystem::temp_directory_path();
+    MappedFile f;
+    CHECK(!f.open((dir / "wolf_test_no_such_file.bin").string()));
+    std::string empty = (dir / "wolf_test_mapped_empty.bin").string();
+    std::ofstream(empty, std::ios::binary | std::ios::trunc).close();
+    CHECK(!f.open(empty));
+    CHECK(!f.isOpen());
+}
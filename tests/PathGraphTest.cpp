@@ -0,0 +1,111 @@
+#include "Check.hpp"
+#include "PathGraph.hpp"
+#include <cstdlib>
+
+// Two rooms joined by a door (D), a third behind a locked one (L)
+static const TestGrid rooms{{
+    "#############",
+    "#...#...#...#",
+    "#...D...L...#",
+    "#...#...#...#",
+    "#############",
+}};
+
+static void buildRooms(PathGraph& g) {
+    g.build(rooms.width(), rooms.height(),
+        [](int x, int y) { return rooms.at(x, y) == '.'; },
+        [](int x, int y) { return rooms.at(x, y) == 'D' || rooms.at(x, y) == 'L'; },
+        [](int x, int y) { return rooms.at(x, y) == 'L'; });
+}
+
+// Follows the route; true if it reaches (gx, gy) in unit steps
+static bool walk(const PathGraph& g, int x, int y, int gx, int gy) {
+    PathRoute route;
+    if (!g.plan(x, y, gx, gy, route)) return false;
+    for (int steps = 0; steps < 100 && (x != gx || y != gy); steps++) {
+        int nx, ny;
+        if (!g.nextStep(x, y, route, nx, ny)) return false;
+        if (std::abs(nx - x) + std::abs(ny - y) != 1 || rooms.wall(nx, ny)) return false;
+        x = nx;
+        y = ny;
+    }
+    return x == gx && y == gy;
+}
+
+TEST(pathGraphClustersSplitAtDoors) {
+    PathGraph g;
+    buildRooms(g);
+    CHECK(g.clusterCount() == 3);
+    CHECK(g.clusterAt(1, 1) != g.clusterAt(5, 1));
+    CHECK(g.clusterAt(4, 2) == -1);  // the door itself
+    CHECK(g.clusterAt(0, 0) == -1);
+}
+
+TEST(pathGraphRoutesThroughAnOpenDoor) {
+    PathGraph g;
+    buildRooms(g);
+    CHECK(walk(g, 1, 1, 7, 3));
+}
+
+TEST(pathGraphLockedDoorBlocksUntilOpened) {
+    PathGraph g;
+    buildRooms(g);
+    PathRoute route;
+    CHECK(!g.plan(1, 1, 11, 2, route));
+    g.setDoorBlocked(8, 2, false);
+    CHECK(walk(g, 1, 1, 11, 2));
+}
+
+TEST(pathGraphSavedFormRoundTrips) {
+    PathGraph built;
+    buildRooms(built);
+    PathGraph::Saved saved;
+    built.save(saved);
+    std::vector<int32_t> tiles(built.clusterTiles(),
+                               built.clusterTiles() + rooms.width() * rooms.height());
+    PathGraph loaded;
+    CHECK(loaded.load(rooms.width(), rooms.height(), tiles.data(), saved));
+    CHECK(loaded.clusterCount() == built.clusterCount());
+    CHECK(loaded.portalCount() == built.portalCount());
+    CHECK(walk(loaded, 1, 1, 7, 3));
+}
+
+TEST(pathGraphLoadRejectsBadIndices) {
+    PathGraph built;
+    buildRooms(built);
+    PathGraph::Saved good;
+    built.save(good);
+    std::vector<int32_t> tiles(built.clusterTiles(),
+                               built.clusterTiles() + rooms.width() * rooms.height());
+    PathGraph g;
+
+    PathGraph::Saved bad = good;
+    bad.edges[0].to = (int32_t)bad.nodes.size();
+    CHECK(!g.load(rooms.width(), rooms.height(), tiles.data(), bad));
+
+    bad = good;
+    bad.edges[0].door = (int32_t)bad.doors.size();
+    CHECK(!g.load(rooms.width(), rooms.height(), tiles.data(), bad));
+
+    bad = good;
+    bad.clusters[0].memberCount = (int32_t)bad.members.size() + 1;
+    CHECK(!g.load(rooms.width(), rooms.height(), tiles.data(), bad));
+
+    bad = good;
+    bad.nodes[0].cluster = -1;
+    CHECK(!g.load(rooms.width(), rooms.height(), tiles.data(), bad));
+
+    bad = good;
+    bad.clusters[0].x0 = 5;          // not a sector origin
+    CHECK(!g.load(rooms.width(), rooms.height(), tiles.data(), bad));
+
+    bad = good;
+    bad.doors[0].x = rooms.width();
+    CHECK(!g.load(rooms.width(), rooms.height(), tiles.data(), bad));
+
+    std::vector<int32_t> badTiles = tiles;
+    badTiles[0] = (int32_t)good.clusters.size();
+    CHECK(!g.load(rooms.width(), rooms.height(), badTiles.data(), good));
+
+    CHECK(g.load(rooms.width(), rooms.height(), tiles.data(), good));
+}
@@ -0,0 +1,60 @@
+#include "Check.hpp"
+#include "SpatialHash.hpp"
+#include <algorithm>
+
+static bool has(const std::vector<int>& v, int id) {
+    return std::find(v.begin(), v.end(), id) != v.end();
+}
+
+TEST(spatialHashRadiusFindsOnlyNearIds) {
+    SpatialHash h;
+    h.insert(0, 1.5f, 1.5f);
+    h.insert(1, 2.2f, 1.5f);
+    h.insert(2, 9.5f, 9.5f);
+    std::vector<int> out;
+    h.queryRadius(1.5f, 1.5f, 1.0f, out);
+    CHECK(has(out, 0));
+    CHECK(has(out, 1));
+    CHECK(!has(out, 2));
+}
+
+TEST(spatialHashUpdateMovesBetweenCells) {
+    SpatialHash h;
+    h.insert(3, 0.5f, 0.5f);
+    h.update(3, 20.5f, 0.5f);
+    std::vector<int> out;
+    h.queryAABB(0.0f, 0.0f, 1.0f, 1.0f, out);
+    CHECK(!has(out, 3));
+    h.queryAABB(20.0f, 0.0f, 21.0f, 1.0f, out);
+    CHECK(has(out, 3));
+    CHECK(h.positionOf(3).first == 20.5f);
+}
+
+TEST(spatialHashRemoveAndClear) {
+    SpatialHash h;
+    h.insert(0, 1.5f, 1.5f);
+    h.insert(1, 1.6f, 1.6f);
+    h.remove(0);
+    h.remove(0); // twice is harmless
+    CHECK(!h.contains(0));
+    CHECK(h.contains(1));
+    std::vector<int> out;
+    h.queryRadius(1.5f, 1.5f, 0.5f, out);
+    CHECK(out.size() == 1 && out[0] == 1);
+    h.clear();
+    CHECK(!h.contains(1));
+    h.queryRadius(1.5f, 1.5f, 0.5f, out);
+    CHECK(out.empty());
+}
+
+TEST(spatialHashRayIsSortedAndPadded) {
+    SpatialHash h;
+    h.insert(5, 4.5f, 1.5f);   // on the ray
+    h.insert(2, 8.5f, 2.4f);   // a cell off it, within padding
+    h.insert(7, 3.5f, 6.5f);   // far off
+    std::vector<int> out;
+    h.queryRay(0.5f, 1.5f, 1.0f, 0.0f, 10.0f, 1.0f, out);
+    CHECK(out.size() == 2);
+    CHECK(std::is_sorted(out.begin(), out.end()));
+    CHECK(has(out, 5) && has(out, 2) && !has(out, 7));
+}
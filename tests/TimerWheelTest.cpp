@@ -0,0 +1,122 @@
+#include "Check.hpp"
+#include "TimerWheel.hpp"
+
+// Ticks until a timer of `delay` fires, or 0 if it has not after limit
+static uint64_t firesAfter(TimerWheel& w, uint32_t delay, uint64_t limit) {
+    uint64_t start = w.now(), firedAt = 0;
+    w.schedule(delay, [&] { firedAt = w.now(); });
+    while (!firedAt && w.now() - start < limit)
+        w.tick();
+    return firedAt ? firedAt - start : 0;
+}
+
+TEST(timerWheelFiresOnTimeAcrossLevelBoundaries) {
+    const uint32_t delays[] = {1, 2, 63, 64, 65, 127, 128, 4095, 4096, 4097,
+                               262143, 262144, 262145};
+    // From several clock phases, so cascades land on slot edges too
+    const uint32_t phases[] = {0, 1, 63, 4095, 262143};
+    for (uint32_t phase : phases)
+        for (uint32_t delay : delays) {
+            TimerWheel w;
+            for (uint32_t i = 0; i < phase; i++)
+                w.tick();
+            uint64_t got = firesAfter(w, delay, delay + 2);
+            CHECK(got == delay);
+            if (got != delay)
+                std::printf("  phase %u delay %u fired after %llu\n", phase, delay,
+                            (unsigned long long)got);
+        }
+}
+
+TEST(timerWheelZeroDelayMeansNextTick) {
+    TimerWheel w;
+    CHECK(firesAfter(w, 0, 5) == 1);
+}
+
+TEST(timerWheelBeyondTheHorizonStillFires) {
+    TimerWheel w;
+    uint32_t delay = (1u << 24) + 100;
+    CHECK(firesAfter(w, delay, delay + 2) == delay);
+}
+
+TEST(timerWheelCancelledTimersDoNotFire) {
+    TimerWheel w;
+    int fired = 0;
+    TimerWheel::TimerId a = w.schedule(70, [&] { fired++; });
+    TimerWheel::TimerId b = w.schedule(70, [&] { fired += 10; });
+    CHECK(w.pending(a) && w.pending(b));
+    w.cancel(a);
+    w.cancel(a); // twice is harmless
+    CHECK(!w.pending(a));
+    for (int i = 0; i < 80; i++)
+        w.tick();
+    CHECK(fired == 10);
+    CHECK(!w.pending(b));
+}
+
+TEST(timerWheelStaleIdsDoNotTouchReusedSlots) {
+    TimerWheel w;
+    int fired = 0;
+    TimerWheel::TimerId old = w.schedule(1, [&] { fired++; });
+    w.tick();
+    CHECK(fired == 1);
+    TimerWheel::TimerId reused = w.schedule(3, [&] { fired += 10; });
+    CHECK(static_cast<uint32_t>(old) == static_cast<uint32_t>(reused)); // same pool slot
+    CHECK(!w.pending(old));
+    w.cancel(old);
+    CHECK(w.pending(reused));
+    for (int i = 0; i < 3; i++)
+        w.tick();
+    CHECK(fired == 11);
+    CHECK(!w.pending(0));
+}
+
+TEST(timerWheelCallbacksMayRescheduleAndCancel) {
+    TimerWheel w;
+    int periodic = 0, victim = 0;
+    TimerWheel::TimerId later = 0;
+    std::function<void()> every5 = [&] {
+        periodic++;
+        w.schedule(5, every5);
+    };
+    w.schedule(5, every5);
+    later = w.schedule(5, [&] { victim++; });
+    // Slots run newest first, so this one runs before `later`
+    w.schedule(5, [&] { w.cancel(later); });
+    for (int i = 0; i < 50; i++)
+        w.tick();
+    CHECK(periodic == 10);
+    CHECK(victim == 0);
+}
+
+TEST(timerWheelClearInsideACallbackStopsTheSlot) {
+    TimerWheel w;
+    int fired = 0;
+    w.schedule(4, [&] { fired += 100; });
+    w.schedule(4, [&] { fired++; w.clear(); }); // newest, runs first
+    TimerWheel::TimerId far = w.schedule(200, [&] { fired += 1000; });
+    for (int i = 0; i < 300; i++)
+        w.tick();
+    CHECK(fired == 1);
+    CHECK(!w.pending(far));
+    // The pool is intact afterwards: new timers fire, each once
+    int after = 0;
+    for (int i = 1; i <= 20; i++)
+        w.schedule(i, [&] { after++; });
+    for (int i = 0; i < 30; i++)
+        w.tick();
+    CHECK(after == 20);
+}
+
+TEST(timerWheelClearDropsEverythingButKeepsTheClock) {
+    TimerWheel w;
+    int fired = 0;
+    TimerWheel::TimerId id = w.schedule(10, [&] { fired++; });
+    w.tick();
+    w.clear();
+    CHECK(!w.pending(id));
+    CHECK(w.now() == 1);
+    for (int i = 0; i < 20; i++)
+        w.tick();
+    CHECK(fired == 0);
+}
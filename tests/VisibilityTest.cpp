@@ -0,0 +1,49 @@
+#include "Check.hpp"
+#include "Visibility.hpp"
+
+static const TestGrid room{{
+    "##########",
+    "#........#",
+    "#........#",
+    "#...#....#",
+    "#........#",
+    "##########",
+}};
+
+static VisibilityField castFrom(int x, int y, int radius) {
+    VisibilityField v;
+    v.compute(x, y, room.width(), room.height(), radius,
+              [](int tx, int ty) { return room.wall(tx, ty); });
+    return v;
+}
+
+TEST(visibilityOpenTilesAndWallFacesAreSeen) {
+    VisibilityField v = castFrom(1, 1, 20);
+    CHECK(v.isVisible(1, 1));
+    CHECK(v.isVisible(8, 1));
+    CHECK(v.isVisible(0, 0));      // wall face
+    CHECK(v.isVisible(4, 3));      // the pillar itself
+    CHECK(!v.isVisible(-1, 0));    // off the map
+}
+
+TEST(visibilityPillarCastsAShadow) {
+    VisibilityField v = castFrom(2, 2, 20);
+    CHECK(!v.isVisible(6, 4));     // straight behind the pillar
+    CHECK(v.isVisible(6, 1));
+}
+
+TEST(visibilityRadiusLimitsTheCast) {
+    VisibilityField v = castFrom(1, 1, 2);
+    CHECK(v.isVisible(2, 2));
+    CHECK(!v.isVisible(8, 4));
+}
+
+TEST(visibilityRecastClearsTheOldField) {
+    VisibilityField v = castFrom(1, 1, 20);
+    CHECK(v.isVisible(1, 1));
+    v.compute(8, 4, room.width(), room.height(), 1,
+              [](int tx, int ty) { return room.wall(tx, ty); });
+    CHECK(!v.isVisible(1, 1));
+    CHECK(v.isVisible(8, 4));
+    CHECK(v.originX() == 8 && v.originY() == 4);
+}
@@ -0,0 +1,26 @@
+#include "Check.hpp"
+
+std::vector<TestCase>& testCases() {
+    static std::vector<TestCase> cases;
+    return cases;
+}
+
+int& checkFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+int main() {
+    int failed = 0;
+    for (const TestCase& t : testCases()) {
+        int before = checkFailures();
+        t.fn();
+        if (checkFailures() != before) {
+            std::printf("FAIL %s\n", t.name);
+            failed++;
+        }
+    }
+    std::printf("%d/%d tests passed\n", (int)testCases().size() - failed,
+                (int)testCases().size());
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,133 @@
+// Asset packer: writes the files under the given directories into one
+// pack (PackFormat.hpp) for AssetPack to map at startup. Run it from the
+// game directory: entries are named by their path from there, as the
+// configs spell them ("Textures/Walls/1.png").
+#include "../PackFormat.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static uint64_t alignUp(uint64_t n) {
+    return (n + packAlign - 1) / packAlign * packAlign;
+}
+
+static void usage() {
+    std::cerr <<
+        "usage: assetpack [--out file] [dir or file]...\n"
+        "  --out   pack to write (default assets.pak)\n"
+        "  inputs  relative to the game directory\n"
+        "          (default Textures Sounds Music wsjafrikakorps)\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::string outPath = "assets.pak";
+    std::vector<std::string> inputs;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--out" && i + 1 < argc) outPath = argv[++i];
+        else if (arg.compare(0, 2, "--") == 0) {
+            usage();
+            return 1;
+        }
+        else inputs.push_back(arg);
+    }
+    if (inputs.empty())
+        inputs = {"Textures", "Sounds", "Music", "wsjafrikakorps"};
+
+    std::vector<std::string> files;
+    for (const auto& input : inputs) {
+        fs::path root(input);
+        if (root.is_absolute()) {
+            std::cerr << "Skipping " << input << ": paths must be relative to the game directory\n";
+            continue;
+        }
+        std::error_code ec;
+        if (fs::is_regular_file(root, ec)) {
+            files.push_back(root.lexically_normal().generic_string());
+            continue;
+        }
+        if (!fs::is_directory(root, ec)) {
+            std::cerr << "Skipping " << input << ": not found\n";
+            continue;
+        }
+        for (const auto& entry : fs::recursive_directory_iterator(root, ec))
+            if (entry.is_regular_file())
+                files.push_back(entry.path().lexically_normal().generic_string());
+    }
+    // Sorted bytewise, as AssetPack binary-searches the names
+    std::sort(files.begin(), files.end());
+    files.erase(std::unique(files.begin(), files.end()), files.end());
+    if (files.empty()) {
+        std::cerr << "Nothing to pack\n";
+        return 1;
+    }
+
+    std::vector<PackEntry> entries(files.size());
+    std::string names;
+    for (size_t i = 0; i < files.size(); i++) {
+        entries[i].nameOffset = static_cast<uint32_t>(names.size());
+        entries[i].nameLength = static_cast<uint32_t>(files[i].size());
+        names += files[i];
+    }
+
+    PackHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, packMagic, 4);
+    h.version = packVersion;
+    h.byteOrder = packByteOrder;
+    h.count = static_cast<uint32_t>(files.size());
+    h.namesOffset = alignUp(sizeof(PackHeader) + entries.size() * sizeof(PackEntry));
+    h.namesSize = names.size();
+    uint64_t offset = alignUp(h.namesOffset + h.namesSize);
+    for (size_t i = 0; i < files.size(); i++) {
+        std::error_code ec;
+        uint64_t size = fs::file_size(files[i], ec);
+        if (ec || size > INT32_MAX) {
+            std::cerr << "Can't pack " << files[i] << "\n";
+            return 1;
+        }
+        entries[i].offset = offset;
+        entries[i].size = size;
+        offset = alignUp(offset + size);
+    }
+
+    std::ofstream out(outPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Failed to open " << outPath << " for writing\n";
+        return 1;
+    }
+    static const char zeros[packAlign] = {};
+    auto pad = [&]() {
+        out.write(zeros, alignUp(out.tellp()) - static_cast<uint64_t>(out.tellp()));
+    };
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(PackEntry));
+    pad();
+    out.write(names.data(), names.size());
+    pad();
+    for (size_t i = 0; i < files.size(); i++) {
+        std::ifstream in(files[i], std::ios::binary);
+        std::vector<char> bytes((std::istreambuf_iterator<char>(in)),
+                                std::istreambuf_iterator<char>());
+        if (bytes.size() != entries[i].size) {
+            std::cerr << "Failed to read " << files[i] << "\n";
+            return 1;
+        }
+        out.write(bytes.data(), bytes.size());
+        pad();
+    }
+    if (!out) {
+        std::cerr << "Failed to write " << outPath << "\n";
+        return 1;
+    }
+    std::cout << "Packed " << files.size() << " files, " << offset / 1024 << " KB: "
+              << outPath << "\n";
+    return 0;
+}
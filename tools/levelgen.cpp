@@ -0,0 +1,379 @@
+// Stress level generator: writes a map and an enemy list in the formats
+// Game::loadMapDataFromFile and Game::loadEnemies read, at any size.
+// The same seed and options always give the same files (splitmix RNG,
+// no std distributions), so benchmark runs compare across builds.
+//
+// Layout: the map is cut into square cells, one room per cell. A random
+// spanning tree over the cells joins neighbouring rooms with corridors;
+// some tree edges get locked doors, and each lock raises the key tier of
+// everything behind it. The key for tier k lies in a tier k-1 room, so
+// the level is always solvable. Extra corridors close loops between
+// rooms of the same tier. The exit switch is in the deepest room.
+#include "../Random.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct Options {
+    int width = 64, height = 64;
+    uint64_t seed = 1;
+    int cell = 12;              // cell side in tiles, one room per cell
+    float enemyDensity = 0.05f; // per room tile
+    float pickupDensity = 0.01f;
+    float decorDensity = 0.02f;
+    float locks = 0.1f;         // chance a tree edge gets a locked door
+    float doors = 0.7f;         // chance an unlocked corridor gets a door
+    float loops = 0.1f;         // chance of an extra corridor between same-tier rooms
+    std::vector<std::string> types; // enemy archetypes, none = default type
+    std::string mapPath = "map.txt";
+    std::string enemiesPath = "enemies.txt";
+};
+
+// Room interior, [x0, x1) x [y0, y1)
+struct Room {
+    int x0, y0, x1, y1;
+};
+
+// Tile values as the map file spells them: numbers below 14, tokens as
+// their letter
+static const uint8_t FLOOR = 0;
+static const uint8_t DOOR = 6; // + key type for locked doors
+static const uint8_t wallIds[] = {1, 2, 3, 4, 5, 10, 11, 12, 13};
+static bool isWall(uint8_t t) { return (t >= 1 && t <= 5) || (t >= 10 && t <= 13); }
+static const char keyTokens[] = {'B', 'R', 'G'};
+static const char decorTokens[] = {'I', 'l', 'L', 'i', 't', 'T', 'W'};
+static const char pickupTokens[] = {'h', 'H', 'a', 'A'};
+
+class Level {
+public:
+    Level(const Options& o) : opt(o), rng(o.seed) {}
+
+    bool generate();
+    bool write() const;
+
+private:
+    uint8_t& at(int x, int y) { return grid[(size_t)y * opt.width + x]; }
+    void layRooms();
+    void carve(int a, int b, uint8_t door);
+    void connect();
+    bool placeFree(int cellId, char token);
+    void placeObjects();
+
+    const Options& opt;
+    Random rng;
+    int cellsX = 0, cellsY = 0;
+    std::vector<uint8_t> grid;
+    std::vector<Room> rooms;
+    std::vector<int> depth, parent;
+    std::vector<int8_t> tier;
+    int doorCount = 0, lockCount = 0, pickupCount = 0;
+};
+
+void Level::layRooms() {
+    int c = opt.cell;
+    rooms.resize((size_t)cellsX * cellsY);
+    for (int cy = 0; cy < cellsY; cy++) {
+        for (int cx = 0; cx < cellsX; cx++) {
+            // Cell walls take this cell's texture
+            uint8_t wall = wallIds[rng.range(sizeof(wallIds))];
+            for (int y = cy * c; y < (cy + 1) * c; y++)
+                for (int x = cx * c; x < (cx + 1) * c; x++)
+                    at(x, y) = wall;
+
+            // Interior fits in [1, c-2) of the cell, leaving at least
+            // three wall tiles between neighbouring rooms
+            int rw = 3 + rng.range(c - 5), rh = 3 + rng.range(c - 5);
+            Room r;
+            r.x0 = cx * c + 1 + rng.range(c - 3 - rw + 1);
+            r.y0 = cy * c + 1 + rng.range(c - 3 - rh + 1);
+            if (cx == 0 && cy == 0) { // the player spawns at (1, 1)
+                r.x0 = 1;
+                r.y0 = 1;
+            }
+            r.x1 = r.x0 + rw;
+            r.y1 = r.y0 + rh;
+            for (int y = r.y0; y < r.y1; y++)
+                for (int x = r.x0; x < r.x1; x++)
+                    at(x, y) = FLOOR;
+            rooms[(size_t)cy * cellsX + cx] = r;
+        }
+    }
+}
+
+// Corridor between neighbouring rooms a (left of / above b) and b: out
+// of a, across the gap with one jog, into b. Jogs keep a tile clear of
+// both rooms' walls, so the first tile outside a always has walls on
+// both sides and can take the door.
+void Level::carve(int a, int b, uint8_t door) {
+    const Room& ra = rooms[a];
+    const Room& rb = rooms[b];
+    bool horizontal = (a / cellsX == b / cellsX);
+    if (horizontal) {
+        int ya = ra.y0 + rng.range(ra.y1 - ra.y0);
+        int yb = rb.y0 + rng.range(rb.y1 - rb.y0);
+        int xm = ra.x1 + 1 + rng.range(rb.x0 - ra.x1 - 2);
+        for (int x = ra.x1; x <= xm; x++) at(x, ya) = FLOOR;
+        for (int y = std::min(ya, yb); y <= std::max(ya, yb); y++) at(xm, y) = FLOOR;
+        for (int x = xm; x < rb.x0; x++) at(x, yb) = FLOOR;
+        if (door) at(ra.x1, ya) = door;
+    } else {
+        int xa = ra.x0 + rng.range(ra.x1 - ra.x0);
+        int xb = rb.x0 + rng.range(rb.x1 - rb.x0);
+        int ym = ra.y1 + 1 + rng.range(rb.y0 - ra.y1 - 2);
+        for (int y = ra.y1; y <= ym; y++) at(xa, y) = FLOOR;
+        for (int x = std::min(xa, xb); x <= std::max(xa, xb); x++) at(x, ym) = FLOOR;
+        for (int y = ym; y < rb.y0; y++) at(xb, y) = FLOOR;
+        if (door) at(xa, ra.y1) = door;
+    }
+    if (door) doorCount++;
+    if (door > DOOR) lockCount++;
+}
+
+void Level::connect() {
+    size_t n = rooms.size();
+    depth.assign(n, -1);
+    parent.assign(n, -1);
+    tier.assign(n, 0);
+    // Randomised depth-first tree from the start room; explicit stack,
+    // since a backtracker on a big map goes millions of rooms deep
+    std::vector<int> stack{0};
+    depth[0] = 0;
+    int next[4];
+    while (!stack.empty()) {
+        int cur = stack.back();
+        int cx = cur % cellsX, cy = cur / cellsX;
+        int count = 0;
+        if (cx > 0 && depth[cur - 1] < 0) next[count++] = cur - 1;
+        if (cx + 1 < cellsX && depth[cur + 1] < 0) next[count++] = cur + 1;
+        if (cy > 0 && depth[cur - cellsX] < 0) next[count++] = cur - cellsX;
+        if (cy + 1 < cellsY && depth[cur + cellsX] < 0) next[count++] = cur + cellsX;
+        if (count == 0) {
+            stack.pop_back();
+            continue;
+        }
+        int child = next[rng.range(count)];
+        depth[child] = depth[cur] + 1;
+        parent[child] = cur;
+        uint8_t door = 0;
+        if (tier[cur] < 3 && rng.unit() < opt.locks) {
+            tier[child] = tier[cur] + 1;
+            door = DOOR + tier[child];
+        } else {
+            tier[child] = tier[cur];
+            door = rng.unit() < opt.doors ? DOOR : 0;
+        }
+        carve(std::min(cur, child), std::max(cur, child), door);
+        stack.push_back(child);
+    }
+
+    // Loops: only within a tier, so a lock is never bypassed, and only
+    // between rooms the tree did not join (one corridor per wall)
+    if (opt.loops <= 0.0f) return;
+    auto loop = [&](int a, int b) {
+        if (tier[a] != tier[b] || parent[a] == b || parent[b] == a) return;
+        if (rng.unit() < opt.loops)
+            carve(a, b, rng.unit() < opt.doors ? DOOR : 0);
+    };
+    for (int cy = 0; cy < cellsY; cy++) {
+        for (int cx = 0; cx < cellsX; cx++) {
+            int cur = cy * cellsX + cx;
+            if (cx + 1 < cellsX) loop(cur, cur + 1);
+            if (cy + 1 < cellsY) loop(cur, cur + cellsX);
+        }
+    }
+}
+
+// Puts token on a free floor tile of the room; false if none was found
+bool Level::placeFree(int cellId, char token) {
+    const Room& r = rooms[cellId];
+    for (int attempt = 0; attempt < 64; attempt++) {
+        int x = r.x0 + rng.range(r.x1 - r.x0);
+        int y = r.y0 + rng.range(r.y1 - r.y0);
+        if (at(x, y) != FLOOR || (x == 1 && y == 1)) continue;
+        at(x, y) = static_cast<uint8_t>(token);
+        return true;
+    }
+    return false;
+}
+
+void Level::placeObjects() {
+    int n = static_cast<int>(rooms.size());
+
+    // Weapons: knife and pistol at the start, rifle anywhere else
+    placeFree(0, 'K');
+    placeFree(0, 'P');
+    if (n > 1) placeFree(1 + rng.range(n - 1), 'S');
+
+    // Key k in a uniformly chosen tier k-1 room (reservoir sampling)
+    for (int k = 1; k <= 3; k++) {
+        int chosen = -1, seen = 0;
+        bool needed = false;
+        for (int i = 0; i < n; i++) {
+            if (tier[i] == k) needed = true;
+            if (tier[i] == k - 1 && rng.range(++seen) == 0) chosen = i;
+        }
+        if (needed && chosen >= 0) placeFree(chosen, keyTokens[k - 1]);
+    }
+
+    // Exit switch in a wall of the deepest room, where no corridor enters
+    int deepest = 0;
+    for (int i = 1; i < n; i++)
+        if (depth[i] > depth[deepest]) deepest = i;
+    const Room& r = rooms[deepest];
+    for (int x = r.x0; x < r.x1; x++) {
+        uint8_t& t = at(x, r.y0 - 1);
+        if (isWall(t)) {
+            t = 'E';
+            break;
+        }
+    }
+
+    // Pickups and decorations over every room
+    for (int i = 0; i < n; i++) {
+        const Room& room = rooms[i];
+        for (int y = room.y0; y < room.y1; y++) {
+            for (int x = room.x0; x < room.x1; x++) {
+                if (at(x, y) != FLOOR || (x == 1 && y == 1)) continue;
+                float roll = rng.unit();
+                if (roll < opt.pickupDensity) {
+                    at(x, y) = pickupTokens[rng.range(sizeof(pickupTokens))];
+                    pickupCount++;
+                }
+                else if (roll < opt.pickupDensity + opt.decorDensity)
+                    at(x, y) = decorTokens[rng.range(sizeof(decorTokens))];
+            }
+        }
+    }
+}
+
+bool Level::generate() {
+    if (opt.cell < 6 || opt.width < opt.cell + 1 || opt.height < opt.cell + 1) {
+        std::cerr << "Map must be at least one cell (" << opt.cell
+                  << " + 1 tiles) wide and high, cells at least 6 tiles\n";
+        return false;
+    }
+    // The last row and column stay wall: cells cover [0, cells * cell)
+    cellsX = (opt.width - 1) / opt.cell;
+    cellsY = (opt.height - 1) / opt.cell;
+    grid.assign((size_t)opt.width * opt.height, wallIds[0]);
+    layRooms();
+    connect();
+    placeObjects();
+    return true;
+}
+
+bool Level::write() const {
+    FILE* map = std::fopen(opt.mapPath.c_str(), "wb");
+    if (!map) {
+        std::cerr << "Failed to open map file for writing: " << opt.mapPath << "\n";
+        return false;
+    }
+    std::string line;
+    for (int y = 0; y < opt.height; y++) {
+        line.clear();
+        for (int x = 0; x < opt.width; x++) {
+            uint8_t t = grid[(size_t)y * opt.width + x];
+            if (x) line += ' ';
+            if (t < 10) line += char('0' + t);
+            else if (t < 14) { line += '1'; line += char('0' + t - 10); }
+            else line += char(t);
+        }
+        line += '\n';
+        std::fwrite(line.data(), 1, line.size(), map);
+    }
+    std::fclose(map);
+
+    FILE* enemies = std::fopen(opt.enemiesPath.c_str(), "wb");
+    if (!enemies) {
+        std::cerr << "Failed to open enemy file for writing: " << opt.enemiesPath << "\n";
+        return false;
+    }
+    // Own stream, so enemy density does not reshuffle the map
+    Random erng(opt.seed ^ 0xE7E7E7E7E7E7E7E7ull);
+    size_t enemyCount = 0;
+    for (size_t i = 1; i < rooms.size(); i++) { // none in the start room
+        const Room& r = rooms[i];
+        for (int y = r.y0; y < r.y1; y++) {
+            for (int x = r.x0; x < r.x1; x++) {
+                if (erng.unit() >= opt.enemyDensity) continue;
+                if (opt.types.empty())
+                    std::fprintf(enemies, "%d.5 %d.5\n", x, y);
+                else
+                    std::fprintf(enemies, "%d.5 %d.5 %s\n", x, y,
+                        opt.types[erng.range((int)opt.types.size())].c_str());
+                enemyCount++;
+            }
+        }
+    }
+    std::fclose(enemies);
+
+    std::cout << opt.width << "x" << opt.height << ", seed " << opt.seed << ": "
+              << rooms.size() << " rooms, " << doorCount << " doors ("
+              << lockCount << " locked), " << pickupCount << " pickups, "
+              << enemyCount << " enemies\n";
+    return true;
+}
+
+static void usage() {
+    std::cerr <<
+        "usage: levelgen [options]\n"
+        "  --size N            square map, N x N tiles (default 64)\n"
+        "  --width W --height H\n"
+        "  --seed S            (default 1)\n"
+        "  --cell N            room cell side in tiles (default 12)\n"
+        "  --enemy-density F   enemies per room tile (default 0.05)\n"
+        "  --pickup-density F  health/ammo per room tile (default 0.01)\n"
+        "  --decor-density F   decorations per room tile (default 0.02)\n"
+        "  --locks F           chance a corridor on the main tree is locked (0.1)\n"
+        "  --doors F           chance an unlocked corridor gets a door (0.7)\n"
+        "  --loops F           chance of extra corridors between rooms (0.1)\n"
+        "  --types a,b,...     enemy archetypes to pick from\n"
+        "  --map FILE          map output (default map.txt)\n"
+        "  --enemies FILE      enemy output (default enemies.txt)\n";
+}
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            usage();
+            return 1;
+        }
+        std::string val = argv[++i];
+        if (arg == "--size") opt.width = opt.height = std::atoi(val.c_str());
+        else if (arg == "--width") opt.width = std::atoi(val.c_str());
+        else if (arg == "--height") opt.height = std::atoi(val.c_str());
+        else if (arg == "--seed") opt.seed = std::strtoull(val.c_str(), nullptr, 10);
+        else if (arg == "--cell") opt.cell = std::atoi(val.c_str());
+        else if (arg == "--enemy-density") opt.enemyDensity = std::atof(val.c_str());
+        else if (arg == "--pickup-density") opt.pickupDensity = std::atof(val.c_str());
+        else if (arg == "--decor-density") opt.decorDensity = std::atof(val.c_str());
+        else if (arg == "--locks") opt.locks = std::atof(val.c_str());
+        else if (arg == "--doors") opt.doors = std::atof(val.c_str());
+        else if (arg == "--loops") opt.loops = std::atof(val.c_str());
+        else if (arg == "--map") opt.mapPath = val;
+        else if (arg == "--enemies") opt.enemiesPath = val;
+        else if (arg == "--types") {
+            size_t start = 0;
+            while (start <= val.size()) {
+                size_t comma = val.find(',', start);
+                if (comma == std::string::npos) comma = val.size();
+                if (comma > start) opt.types.push_back(val.substr(start, comma - start));
+                start = comma + 1;
+            }
+        }
+        else {
+            usage();
+            return 1;
+        }
+    }
+
+    Level level(opt);
+    if (!level.generate() || !level.write())
+        return 1;
+    return 0;
+}